@@ -0,0 +1,628 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+/* Benchmark of the ConsoleControl output functions and UI elements
+ * Usage: ConsoleControlBench [name_filter]
+ * Each function is run against /dev/null, against a pseudo-terminal (which master is read by a thread) and
+ * against a virtual terminal (outputs interpreted, the time includes the display of the last outputs), the time,
+ * the bytes written and the read / write system calls (from /proc/thread-self/io) are reported per operation.
+ * The UI elements read their inputs from another pseudo-terminal (the virtual terminal for its target), an enter
+ * key is written before each display. Linux only. */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+#include <ConsoleControl.h>
+#include <ConsoleControlUtility.h>
+#include <ConsoleControlUI.h>
+#include <ConsoleControlScreen.h>
+#include <UnixConsoleControl.h>
+#include <ConsoleControlVirtualTerminal.h>
+
+#ifdef __linux__
+
+// Size of the benchmarked console
+#define BENCH_WIDTH 120
+#define BENCH_HEIGHT 40
+
+// Size of the large screens, the console size is changed while they are flushed
+#define LARGE_WIDTH 500
+#define LARGE_HEIGHT 200
+
+// Size of the layer moved over a large screen
+#define LAYER_WIDTH 100
+#define LAYER_HEIGHT 40
+
+// Number of operations of the benchmarks, by cost
+#define FAST_ITERATIONS 200000
+#define DRAW_ITERATIONS 20000
+#define FRAME_ITERATIONS 2000
+
+typedef struct {
+	const char* name;
+	void (* run)(unsigned long i);
+	unsigned long iterations;
+} Benchmark;
+
+typedef struct {
+	unsigned long long bytes;
+	unsigned long long rwSyscalls; /* read and write system calls only, the others are not counted by Linux */
+} IoCounters;
+
+// Master of the pseudo-terminal the UI elements read their inputs from
+static int inputMaster = -1;
+
+// Virtual terminal of the current target, NULL for the others
+static cc_VirtualTerminal* terminal = NULL;
+
+// Screen of the screen and modal messages benchmarks
+static cc_Screen* screen = NULL;
+
+// Large screens, for the differences and for the layers composition
+static cc_Screen* diffScreen = NULL;
+static cc_Screen* layerScreen = NULL;
+static cc_Layer* layer = NULL;
+
+// UI elements
+static const char* menuChoices[] = {"First choice", "Second choice", "Third choice", "Quit"};
+
+static cc_Menu menu = {"Benchmark menu", menuChoices, 4, 0, -1};
+
+static const cc_MenuColors menuColors = {BLACK, CYAN, BLACK, WHITE, BLACK, CYAN, BLACK};
+
+static cc_Message message = {"Benchmark message", "First line of the message\nSecond line of the message", "Yes",
+                             NULL, "No", LEFT_CHOICE, true};
+
+static const cc_MessageColors messageColors = {BLACK, CYAN, BLACK, WHITE, BLACK, WHITE, BLACK, CYAN, BLACK};
+
+static cc_IntegerOption integerOption = {42, -100, 200, 1};
+
+static cc_CharacterOption characterOption = {'g', 'a', 'z'};
+
+static const char* optionChoices[] = {"choice 1", "very very long choice", "choice 2"};
+
+static cc_ChoicesOption choicesOption = {optionChoices, 3, 1};
+
+static cc_Option options[3];
+
+static cc_Option* optionsPointers[] = {&options[0], &options[1], &options[2]};
+
+static cc_OptionsMenu optionsMenu = {"Benchmark options menu", optionsPointers, 3, 3, "OK", false};
+
+// For main, open a pseudo-terminal of the benchmarked size, return the master
+static int openPseudoTerminal(int* slave);
+
+// For main, read the outputs written to the pseudo-terminal
+static void* drain(void* data);
+
+// For runBenchmark
+static bool readIoCounters(IoCounters* counters);
+
+// For main
+static void runBenchmark(const Benchmark* benchmark, const char* target);
+
+// For the UI elements benchmarks, input read by the UI element
+static void pressEnter(void);
+
+// Benchmarks
+static void setColors(unsigned long i);
+static void setForegroundColor(unsigned long i);
+static void setBackgroundColor(unsigned long i);
+static void setCursorPosition(unsigned long i);
+static void moveCursor(unsigned long i);
+static void saveRestoreCursor(unsigned long i);
+static void setCursorVisibility(unsigned long i);
+static void clean(unsigned long i);
+static void scrollRegion(unsigned long i);
+static void alternateScreen(unsigned long i);
+static void drawLine(unsigned long i);
+static void drawPatternLine(unsigned long i);
+static void drawTableHorizontalLine(unsigned long i);
+static void drawTableVerticalLine(unsigned long i);
+static void drawRectangle(unsigned long i);
+static void drawTableRectangle(unsigned long i);
+static void drawFullRectangle(unsigned long i);
+static void drawCircle(unsigned long i);
+static void screenFlushCell(unsigned long i);
+static void screenFlushFull(unsigned long i);
+static void screenFlushLargeDiff(unsigned long i);
+static void screenFlushLargeLayer(unsigned long i);
+
+// For the large screens benchmarks and main
+static void flushLargeScreen(cc_Screen* largeScreen);
+
+// For main
+static cc_Screen* createFilledScreen(cc_type width, cc_type height);
+static void displayTableMenu(unsigned long i);
+static void displayColorMenu(unsigned long i);
+static void displayTableMessage(unsigned long i);
+static void displayColorMessage(unsigned long i);
+static void displayTableModalMessage(unsigned long i);
+static void displayColorModalMessage(unsigned long i);
+static void displayTableOptionMenu(unsigned long i);
+static void displayColorOptionMenu(unsigned long i);
+
+static const Benchmark benchmarks[] = {
+	{"cc_setColors", setColors, FAST_ITERATIONS},
+	{"cc_setForegroundColor", setForegroundColor, FAST_ITERATIONS},
+	{"cc_setBackgroundColor", setBackgroundColor, FAST_ITERATIONS},
+	{"cc_setCursorPosition", setCursorPosition, FAST_ITERATIONS},
+	{"cc_moveCursor", moveCursor, FAST_ITERATIONS},
+	{"cc_save/restoreCursorPosition", saveRestoreCursor, FAST_ITERATIONS},
+	{"cc_setCursorVisibility", setCursorVisibility, FAST_ITERATIONS},
+	{"cc_clean", clean, FAST_ITERATIONS},
+	{"cc_scrollRegion", scrollRegion, FAST_ITERATIONS},
+	{"cc_enter/leaveAlternateScreen", alternateScreen, FAST_ITERATIONS},
+	{"cc_drawLine", drawLine, DRAW_ITERATIONS},
+	{"cc_drawPatternLine", drawPatternLine, DRAW_ITERATIONS},
+	{"cc_drawTableHorizontalLine", drawTableHorizontalLine, DRAW_ITERATIONS},
+	{"cc_drawTableVerticalLine", drawTableVerticalLine, DRAW_ITERATIONS},
+	{"cc_drawRectangle", drawRectangle, DRAW_ITERATIONS},
+	{"cc_drawTableRectangle", drawTableRectangle, DRAW_ITERATIONS},
+	{"cc_drawFullRectangle", drawFullRectangle, DRAW_ITERATIONS},
+	{"cc_drawCircle", drawCircle, DRAW_ITERATIONS},
+	{"cc_screenFlush (one cell)", screenFlushCell, DRAW_ITERATIONS},
+	{"cc_screenFlush (full)", screenFlushFull, FRAME_ITERATIONS},
+	{"cc_screenFlush (500x200 diff)", screenFlushLargeDiff, FRAME_ITERATIONS},
+	{"cc_screenFlush (500x200 layer)", screenFlushLargeLayer, FRAME_ITERATIONS},
+	{"cc_displayTableMenu", displayTableMenu, FRAME_ITERATIONS},
+	{"cc_displayColorMenu", displayColorMenu, FRAME_ITERATIONS},
+	{"cc_displayTableMessage", displayTableMessage, FRAME_ITERATIONS},
+	{"cc_displayColorMessage", displayColorMessage, FRAME_ITERATIONS},
+	{"cc_displayTableModalMessage", displayTableModalMessage, FRAME_ITERATIONS},
+	{"cc_displayColorModalMessage", displayColorModalMessage, FRAME_ITERATIONS},
+	{"cc_displayTableOptionMenu", displayTableOptionMenu, FRAME_ITERATIONS},
+	{"cc_displayColorOptionMenu", displayColorOptionMenu, FRAME_ITERATIONS}
+};
+
+int openPseudoTerminal(int* slave) {
+	int master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(master == -1) {
+		perror("posix_openpt");
+		return -1;
+	}
+	const char* name;
+	if(grantpt(master) == -1 || unlockpt(master) == -1 || (name = ptsname(master)) == NULL) {
+		perror("pseudo-terminal opening");
+		close(master);
+		return -1;
+	}
+	*slave = open(name, O_RDWR | O_NOCTTY);
+	if(*slave == -1) {
+		perror(name);
+		close(master);
+		return -1;
+	}
+
+	struct winsize size = {BENCH_HEIGHT, BENCH_WIDTH, 0, 0};
+	if(ioctl(*slave, TIOCSWINSZ, &size) == -1) {
+		perror("ioctl");
+	}
+	return master;
+}
+
+void* drain(void* data) {
+	int master = *(int*) data;
+	char buffer[65536];
+	while(read(master, buffer, sizeof(buffer)) > 0 || errno == EINTR) {
+		continue;
+	}
+	return NULL;
+}
+
+bool readIoCounters(IoCounters* counters) {
+	FILE* file = fopen("/proc/thread-self/io", "r");
+	if(file == NULL) {
+		return false;
+	}
+	char name[32];
+	unsigned long long value;
+	unsigned long long rwSyscalls = 0;
+	counters->bytes = 0;
+	while(fscanf(file, "%31[^:]: %llu ", name, &value) == 2) {
+		if(strcmp(name, "wchar") == 0) {
+			counters->bytes = value;
+		}
+		else if(strcmp(name, "syscr") == 0 || strcmp(name, "syscw") == 0) {
+			rwSyscalls += value;
+		}
+	}
+	fclose(file);
+	counters->rwSyscalls = rwSyscalls;
+	return true;
+}
+
+void runBenchmark(const Benchmark* benchmark, const char* target) {
+	for(unsigned long i = 0; i < benchmark->iterations / 10; ++i) {
+		benchmark->run(i);
+	}
+	fflush(cc_getOutput());
+
+	IoCounters before;
+	IoCounters after;
+	bool counted = readIoCounters(&before);
+	struct timespec start;
+	struct timespec end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for(unsigned long i = 0; i < benchmark->iterations; ++i) {
+		benchmark->run(i);
+	}
+	fflush(cc_getOutput());
+	if(terminal != NULL) {
+		cc_virtualTerminalSync(terminal);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	counted = readIoCounters(&after) && counted;
+
+	double iterations = (double) benchmark->iterations;
+	double nanoseconds = (double) (end.tv_sec - start.tv_sec) * 1e9 + (double) (end.tv_nsec - start.tv_nsec);
+	if(counted) {
+		printf("%-32s %-10s %12.1f %12.1f %14.3f\n", benchmark->name, target, nanoseconds / iterations,
+		       (double) (after.bytes - before.bytes) / iterations,
+		       (double) (after.rwSyscalls - before.rwSyscalls) / iterations);
+	}
+	else {
+		printf("%-32s %-10s %12.1f %12s %14s\n", benchmark->name, target, nanoseconds / iterations, "-", "-");
+	}
+	fflush(stdout);
+}
+
+void pressEnter() {
+	if(terminal != NULL) {
+		cc_virtualTerminalInputKey(terminal, ENTER_KEY);
+		return;
+	}
+	if(write(inputMaster, "\n", 1) != 1) {
+		perror("write");
+		exit(EXIT_FAILURE);
+	}
+}
+
+void setColors(unsigned long i) {
+	cc_setColors((cc_Color) (i % 8), (cc_Color) ((i + 1) % 8));
+}
+
+void setForegroundColor(unsigned long i) {
+	cc_setForegroundColor((cc_Color) (i % 16));
+}
+
+void setBackgroundColor(unsigned long i) {
+	cc_setBackgroundColor((cc_Color) (i % 16));
+}
+
+void setCursorPosition(unsigned long i) {
+	cc_Vector2 position = {(cc_type) (i % BENCH_WIDTH), (cc_type) (i / BENCH_WIDTH % BENCH_HEIGHT)};
+	cc_setCursorPosition(position);
+}
+
+void moveCursor(unsigned long i) {
+	cc_Vector2 move = {i & 1 ? 3 : -3, i & 1 ? -1 : 1};
+	cc_moveCursor(move);
+}
+
+void saveRestoreCursor(unsigned long i) {
+	(void) i;
+	cc_saveCursorPosition();
+	cc_restoreCursorPosition();
+}
+
+void setCursorVisibility(unsigned long i) {
+	cc_setCursorVisibility(i & 1);
+}
+
+void clean(unsigned long i) {
+	(void) i;
+	cc_clean();
+}
+
+void scrollRegion(unsigned long i) {
+	cc_scrollRegion(2, BENCH_HEIGHT - 3, i & 1 ? 1 : -1);
+}
+
+void alternateScreen(unsigned long i) {
+	(void) i;
+	cc_enterAlternateScreen();
+	cc_leaveAlternateScreen();
+}
+
+void drawLine(unsigned long i) {
+	cc_Vector2 from = {0, (cc_type) (i % BENCH_HEIGHT)};
+	cc_Vector2 to = {BENCH_WIDTH - 1, (cc_type) ((i + 7) % BENCH_HEIGHT)};
+	cc_drawLine(from, to, '#');
+}
+
+void drawPatternLine(unsigned long i) {
+	cc_Vector2 from = {0, (cc_type) (i % BENCH_HEIGHT)};
+	cc_Vector2 to = {BENCH_WIDTH - 1, (cc_type) ((i + 7) % BENCH_HEIGHT)};
+	cc_drawPatternLine(from, to, "-=");
+}
+
+void drawTableHorizontalLine(unsigned long i) {
+	cc_Vector2 from = {0, (cc_type) (i % BENCH_HEIGHT)};
+	cc_Vector2 to = {BENCH_WIDTH - 1, (cc_type) (i % BENCH_HEIGHT)};
+	cc_drawTableHorizontalLine(from, to);
+}
+
+void drawTableVerticalLine(unsigned long i) {
+	cc_Vector2 from = {(cc_type) (i % BENCH_WIDTH), 0};
+	cc_Vector2 to = {(cc_type) (i % BENCH_WIDTH), BENCH_HEIGHT - 1};
+	cc_drawTableVerticalLine(from, to);
+}
+
+void drawRectangle(unsigned long i) {
+	cc_Vector2 topLeft = {(cc_type) (i % 10), 5};
+	cc_Vector2 downRight = {(cc_type) (60 + i % 10), 25};
+	cc_drawRectangle(topLeft, downRight, '*');
+}
+
+void drawTableRectangle(unsigned long i) {
+	cc_Vector2 topLeft = {(cc_type) (i % 10), 5};
+	cc_Vector2 downRight = {(cc_type) (60 + i % 10), 25};
+	cc_drawTableRectangle(topLeft, downRight);
+}
+
+void drawFullRectangle(unsigned long i) {
+	cc_Vector2 topLeft = {(cc_type) (i % 10), 5};
+	cc_Vector2 downRight = {(cc_type) (60 + i % 10), 25};
+	cc_drawFullRectangle(topLeft, downRight, (char) ('a' + i % 26));
+}
+
+void drawCircle(unsigned long i) {
+	cc_Vector2 center = {BENCH_WIDTH / 2, BENCH_HEIGHT / 2};
+	cc_drawCircle(center, (unsigned int) (5 + i % 10), 'o');
+}
+
+void screenFlushCell(unsigned long i) {
+	cc_Vector2 position = {(cc_type) (i % BENCH_WIDTH), (cc_type) (i / BENCH_WIDTH % BENCH_HEIGHT)};
+	cc_Cell cell = {(char) ('a' + i % 26), BLACK, (cc_Color) (1 + i % 7)};
+	cc_screenSetCell(screen, position, cell);
+	cc_screenFlush(screen);
+}
+
+void screenFlushFull(unsigned long i) {
+	(void) i;
+	cc_screenInvalidate(screen);
+	cc_screenFlush(screen);
+}
+
+void screenFlushLargeDiff(unsigned long i) {
+	/* Two cells changed per line, the lines are compared between them */
+	cc_Cell cell = {(char) ('a' + i % 26), BLACK, (cc_Color) (1 + i % 7)};
+	for(cc_type y = 0; y < LARGE_HEIGHT; ++y) {
+		cc_screenSetCell(diffScreen, (cc_Vector2) {(cc_type) (i % 50), y}, cell);
+		cc_screenSetCell(diffScreen, (cc_Vector2) {(cc_type) (LARGE_WIDTH - 50 + i % 50), y}, cell);
+	}
+	flushLargeScreen(diffScreen);
+}
+
+void screenFlushLargeLayer(unsigned long i) {
+	/* Layer moved by one cell, composited over the screen */
+	cc_layerSetPosition(layer, (cc_Vector2) {(cc_type) (i % (LARGE_WIDTH - LAYER_WIDTH)), 80});
+	flushLargeScreen(layerScreen);
+}
+
+void flushLargeScreen(cc_Screen* largeScreen) {
+	cc_Context* context = cc_getCurrentContext();
+	cc_contextSetSize(context, LARGE_WIDTH, LARGE_HEIGHT);
+	cc_contextScreenFlush(context, largeScreen);
+	cc_contextSetSize(context, BENCH_WIDTH, BENCH_HEIGHT);
+}
+
+cc_Screen* createFilledScreen(cc_type width, cc_type height) {
+	cc_Screen* filledScreen = cc_createScreen(width, height);
+	if(filledScreen == NULL) {
+		return NULL;
+	}
+	cc_Vector2 position;
+	for(position.y = 0; position.y < height; ++position.y) {
+		for(position.x = 0; position.x < width; ++position.x) {
+			cc_Cell cell = {(char) ('!' + (position.x + position.y) % 90), BLACK, (cc_Color) (1 + position.y % 7)};
+			cc_screenSetCell(filledScreen, position, cell);
+		}
+	}
+	return filledScreen;
+}
+
+void displayTableMenu(unsigned long i) {
+	menu.currentChoice = (unsigned int) (i % menu.choicesNumber);
+	pressEnter();
+	cc_displayTableMenu(&menu);
+}
+
+void displayColorMenu(unsigned long i) {
+	menu.currentChoice = (unsigned int) (i % menu.choicesNumber);
+	pressEnter();
+	cc_displayColorMenu(&menu, &menuColors);
+}
+
+void displayTableMessage(unsigned long i) {
+	(void) i;
+	message.currentChoice = LEFT_CHOICE;
+	pressEnter();
+	cc_displayTableMessage(&message);
+}
+
+void displayColorMessage(unsigned long i) {
+	(void) i;
+	message.currentChoice = LEFT_CHOICE;
+	pressEnter();
+	cc_displayColorMessage(&message, &messageColors);
+}
+
+void displayTableModalMessage(unsigned long i) {
+	(void) i;
+	message.currentChoice = LEFT_CHOICE;
+	pressEnter();
+	cc_displayTableModalMessage(&message, screen);
+}
+
+void displayColorModalMessage(unsigned long i) {
+	(void) i;
+	message.currentChoice = LEFT_CHOICE;
+	pressEnter();
+	cc_displayColorModalMessage(&message, &messageColors, screen);
+}
+
+void displayTableOptionMenu(unsigned long i) {
+	(void) i;
+	optionsMenu.selectedOption = optionsMenu.optionsNumber;
+	pressEnter();
+	cc_displayTableOptionMenu(&optionsMenu);
+}
+
+void displayColorOptionMenu(unsigned long i) {
+	(void) i;
+	optionsMenu.selectedOption = optionsMenu.optionsNumber;
+	pressEnter();
+	cc_displayColorOptionMenu(&optionsMenu, &menuColors);
+}
+
+int main(int argc, char* argv[]) {
+	const char* filter = argc > 1 ? argv[1] : NULL;
+
+	options[0].name = "Integer option";
+	options[0].optionType = INTEGER_OPTION;
+	options[0].integerOption = &integerOption;
+	options[1].name = "Character option";
+	options[1].optionType = CHARACTER_OPTION;
+	options[1].characterOption = &characterOption;
+	options[2].name = "Choices option";
+	options[2].optionType = CHOICES_OPTION;
+	options[2].choicesOption = &choicesOption;
+
+	/* Inputs of the UI elements, without echo */
+	int inputSlave;
+	inputMaster = openPseudoTerminal(&inputSlave);
+	if(inputMaster == -1) {
+		return EXIT_FAILURE;
+	}
+	struct termios mode;
+	if(tcgetattr(inputSlave, &mode) == 0) {
+		mode.c_lflag &= ~((tcflag_t) (ICANON | ECHO));
+		tcsetattr(inputSlave, TCSANOW, &mode);
+	}
+
+	int nullFd = open("/dev/null", O_WRONLY);
+	if(nullFd == -1) {
+		perror("/dev/null");
+		return EXIT_FAILURE;
+	}
+	int outputSlave;
+	int outputMaster = openPseudoTerminal(&outputSlave);
+	if(outputMaster == -1) {
+		return EXIT_FAILURE;
+	}
+	pthread_t drainThread;
+	int error = pthread_create(&drainThread, NULL, drain, &outputMaster);
+	if(error) {
+		fprintf(stderr, "pthread_create failed (%s)\n", strerror(error));
+		return EXIT_FAILURE;
+	}
+
+	screen = createFilledScreen(BENCH_WIDTH, BENCH_HEIGHT);
+	diffScreen = createFilledScreen(LARGE_WIDTH, LARGE_HEIGHT);
+	layerScreen = createFilledScreen(LARGE_WIDTH, LARGE_HEIGHT);
+	if(screen == NULL || diffScreen == NULL || layerScreen == NULL) {
+		return EXIT_FAILURE;
+	}
+	layer = cc_createLayer(layerScreen, (cc_Vector2) {0, 80}, LAYER_WIDTH, LAYER_HEIGHT, 1);
+	if(layer == NULL) {
+		return EXIT_FAILURE;
+	}
+	cc_layerFill(layer, (cc_Vector2) {0, 0}, (cc_Vector2) {LAYER_WIDTH - 1, LAYER_HEIGHT - 1},
+	             (cc_Cell) {'#', BLUE, LIGHT_WHITE});
+
+	const char* targetsNames[] = {"/dev/null", "pty", "vt"};
+	int targetsFds[] = {nullFd, outputSlave, -1};
+	printf("%-32s %-10s %12s %12s %14s\n", "function", "output", "ns/op", "bytes/op", "rw syscalls/op");
+	for(size_t target = 0; target < 3; ++target) {
+		cc_Context* context;
+		if(targetsFds[target] != -1) {
+			context = cc_createContext(inputSlave, targetsFds[target]);
+			if(context == NULL) {
+				return EXIT_FAILURE;
+			}
+			/* /dev/null has no size */
+			cc_contextSetSize(context, BENCH_WIDTH, BENCH_HEIGHT);
+		}
+		else {
+			terminal = cc_createVirtualTerminal(BENCH_WIDTH, BENCH_HEIGHT);
+			if(terminal == NULL) {
+				return EXIT_FAILURE;
+			}
+			context = cc_virtualTerminalGetContext(terminal);
+		}
+		cc_setCurrentContext(context);
+		cc_screenInvalidate(screen);
+		cc_screenFlush(screen);
+		cc_screenInvalidate(diffScreen);
+		flushLargeScreen(diffScreen);
+		cc_screenInvalidate(layerScreen);
+		flushLargeScreen(layerScreen);
+
+		for(size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); ++i) {
+			if(filter == NULL || strstr(benchmarks[i].name, filter) != NULL) {
+				runBenchmark(&benchmarks[i], targetsNames[target]);
+			}
+		}
+
+		cc_setCurrentContext(NULL);
+		if(terminal != NULL) {
+			cc_destroyVirtualTerminal(terminal);
+			terminal = NULL;
+		}
+		else {
+			cc_destroyContext(context);
+		}
+	}
+
+	cc_destroyLayer(layer);
+	cc_destroyScreen(layerScreen);
+	cc_destroyScreen(diffScreen);
+	cc_destroyScreen(screen);
+	close(nullFd);
+	close(inputSlave);
+	close(inputMaster);
+	return EXIT_SUCCESS;
+}
+
+#else
+
+int main() {
+	fprintf(stderr, "ConsoleControlBench is only available on Linux\n");
+	return EXIT_FAILURE;
+}
+
+#endif //__linux__
@@ -63,6 +63,9 @@ extern "C" {
 #include <unistd.h>
 #include <termios.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
 #include <sys/ioctl.h>
 
 #define CSI "\033[" //Control Sequence Introducer
@@ -108,6 +111,18 @@ extern "C" {
 //New lines are added at the top.
 #define SD_CODE "T" //Scroll Down, CSI n T
 
+//Sets the scrolling region to lines n to m (1-based, inclusive).
+//Without parameters, the scrolling region is the whole screen.
+//The cursor is moved to the home position.
+#define DECSTBM_CODE "r" //Set Top and Bottom Margins, CSI n ; m r
+
+//Saves the cursor position and switches to the alternate screen buffer, cleared.
+//The alternate screen buffer has no scrollback (xterm extension).
+#define ALTBUF_ENTER_CODE "?1049h" //Alternate Screen Buffer Enter, CSI ?1049h
+
+//Switches back to the normal screen buffer, unchanged, and restores the cursor position.
+#define ALTBUF_LEAVE_CODE "?1049l" //Alternate Screen Buffer Leave, CSI ?1049l
+
 //Moves the cursor to row n, column m.
 //Both default to 1 if omitted. Same as CUP.
 #define HVP_CODE "f" //Horizontal and Vertical Position, CSI n ; m f
@@ -129,10 +144,46 @@ extern "C" {
 //Shows the cursor.
 #define DECTCEM_S_CODE "?25h" //DECTCEM Show, CSI ?25h
 
+//Begins a synchronized update, the terminal keeps presenting the previous
+//frame until the update ends (terminal extension, ignored if not supported).
+#define SYNC_BEGIN_CODE "?2026h" //Synchronized Update Begin, CSI ?2026h
+
+//Ends a synchronized update, the terminal presents the new frame at once.
+#define SYNC_END_CODE "?2026l" //Synchronized Update End, CSI ?2026l
+
+//Requests the state of the synchronized update mode.
+//The terminal replies CSI ?2026;n$y, n is 0 if the mode is not recognized,
+//1 or 2 if set or reset, 3 or 4 if permanently set or reset.
+#define DECRQM_SYNC_CODE "?2026$p" //Request Mode, CSI ?2026$p
+
+//Requests the terminal primary attributes, answered by all terminals.
+//The terminal replies CSI ? ... c
+#define DA1_CODE "c" //Primary Device Attributes, CSI c
+
 //Use with SGR_CODE as n value.
 //Inverse or reverse; swap foreground and background (reverse video).
 #define SGR_REVERSE_VALUE "7" //CSI SGR_REVERSE_VALUE SGR_CODE
 
+//Use with SGR_CODE as n value.
+//Bold or increased intensity.
+#define SGR_BOLD_VALUE "1" //CSI SGR_BOLD_VALUE SGR_CODE
+
+//Use with SGR_CODE as n value.
+//Underline: single.
+#define SGR_UNDERLINE_VALUE "4" //CSI SGR_UNDERLINE_VALUE SGR_CODE
+
+//Use with SGR_CODE as n value.
+//Normal color or intensity; neither bold nor faint.
+#define SGR_NORMAL_INTENSITY_VALUE "22" //CSI SGR_NORMAL_INTENSITY_VALUE SGR_CODE
+
+//Use with SGR_CODE as n value.
+//Underline: none.
+#define SGR_UNDERLINE_OFF_VALUE "24" //CSI SGR_UNDERLINE_OFF_VALUE SGR_CODE
+
+//Use with SGR_CODE as n value.
+//Reverse off.
+#define SGR_REVERSE_OFF_VALUE "27" //CSI SGR_REVERSE_OFF_VALUE SGR_CODE
+
 #endif //OS_WINDOWS
 
 /*-------------------------------------------------------------------------*//**
@@ -154,6 +205,82 @@ typedef struct {
 	cc_type y; /**< y coordinate of the vector */
 } cc_Vector2;
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Console used by the ConsoleControl functions.
+ *
+ * @details    A context holds the input and output of a console and its state
+ *             (console mode, size, output buffer, colors, synchronized
+ *             updates, alternate screen, scrolling region), so one process can
+ *             control several independent consoles, for example the
+ *             pseudo-terminals of remote sessions.
+ *
+ *             Each function has a variant taking the context as first
+ *             parameter (@c cc_setColors and @c cc_contextSetColors for
+ *             example). The other functions, UI elements included, use the
+ *             current context of the calling thread (see @c
+ *             cc_setCurrentContext). A context must not be used by several
+ *             threads at the same time.
+ *
+ *             On Unix, contexts are created with @c cc_createContext. On
+ *             Windows the console is shared by the whole process, only the
+ *             default context exists.
+ *
+ * @since      0.4
+ */
+typedef struct cc_Context cc_Context;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the default context, the console of the process (standard
+ *             input and output).
+ *
+ * @return     The default context
+ *
+ * @since      0.4
+ */
+cc_Context* cc_getDefaultContext();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the current context of the calling thread.
+ *
+ * @return     The current context, the default context if none was set
+ *
+ * @since      0.4
+ */
+cc_Context* cc_getCurrentContext();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the current context of the calling thread, used by the
+ *             functions not taking a context.
+ *
+ * @param      context  The context, NULL for the default context
+ *
+ * @since      0.4
+ */
+void cc_setCurrentContext(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the output stream of the current context.
+ *
+ * @details    Text printed on this stream is displayed with the outputs of the
+ *             ConsoleControl functions.
+ *
+ * @return     The output stream
+ *
+ * @since      0.4
+ */
+FILE* cc_getOutput();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_getOutput, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The output stream
+ *
+ * @since      0.4
+ */
+FILE* cc_contextGetOutput(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set the console output foreground color.
  *
@@ -163,6 +290,16 @@ typedef struct {
  */
 void cc_setForegroundColor(cc_Color color);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_setForegroundColor, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  color    The color
+ *
+ * @since      0.4
+ */
+void cc_contextSetForegroundColor(cc_Context* context, cc_Color color);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set the console output background color.
  *
@@ -172,6 +309,16 @@ void cc_setForegroundColor(cc_Color color);
  */
 void cc_setBackgroundColor(cc_Color color);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_setBackgroundColor, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  color    The color
+ *
+ * @since      0.4
+ */
+void cc_contextSetBackgroundColor(cc_Context* context, cc_Color color);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set the console output background and foreground color.
  *
@@ -182,6 +329,17 @@ void cc_setBackgroundColor(cc_Color color);
  */
 void cc_setColors(cc_Color backgroundColor, cc_Color foregroundColor);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_setColors, on the console of @p context.
+ *
+ * @param      context          The context
+ * @param[in]  backgroundColor  The background color
+ * @param[in]  foregroundColor  The foreground color
+ *
+ * @since      0.4
+ */
+void cc_contextSetColors(cc_Context* context, cc_Color backgroundColor, cc_Color foregroundColor);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Get the console window width.
  *
@@ -191,6 +349,17 @@ void cc_setColors(cc_Color backgroundColor, cc_Color foregroundColor);
  */
 cc_type cc_getWidth();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_getWidth, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The console width
+ *
+ * @since      0.4
+ */
+cc_type cc_contextGetWidth(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Get the console window height.
  *
@@ -200,6 +369,17 @@ cc_type cc_getWidth();
  */
 cc_type cc_getHeight();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_getHeight, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The console height
+ *
+ * @since      0.4
+ */
+cc_type cc_contextGetHeight(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set the cursor position in the console window.
  *
@@ -209,6 +389,16 @@ cc_type cc_getHeight();
  */
 void cc_setCursorPosition(cc_Vector2 position);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_setCursorPosition, on the console of @p context.
+ *
+ * @param      context   The context
+ * @param[in]  position  The position
+ *
+ * @since      0.4
+ */
+void cc_contextSetCursorPosition(cc_Context* context, cc_Vector2 position);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Move the cursor @p steps steps up.
  *
@@ -218,6 +408,16 @@ void cc_setCursorPosition(cc_Vector2 position);
  */
 void cc_moveCursorUp(cc_type steps);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_moveCursorUp, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  steps    The steps
+ *
+ * @since      0.4
+ */
+void cc_contextMoveCursorUp(cc_Context* context, cc_type steps);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Move the cursor @p steps steps down.
  *
@@ -227,6 +427,16 @@ void cc_moveCursorUp(cc_type steps);
  */
 void cc_moveCursorDown(cc_type steps);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_moveCursorDown, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  steps    The steps
+ *
+ * @since      0.4
+ */
+void cc_contextMoveCursorDown(cc_Context* context, cc_type steps);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Move the cursor @p steps steps left.
  *
@@ -236,6 +446,16 @@ void cc_moveCursorDown(cc_type steps);
  */
 void cc_moveCursorLeft(cc_type steps);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_moveCursorLeft, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  steps    The steps
+ *
+ * @since      0.4
+ */
+void cc_contextMoveCursorLeft(cc_Context* context, cc_type steps);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Move the cursor @p steps steps right.
  *
@@ -245,6 +465,16 @@ void cc_moveCursorLeft(cc_type steps);
  */
 void cc_moveCursorRight(cc_type steps);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_moveCursorRight, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  steps    The steps
+ *
+ * @since      0.4
+ */
+void cc_contextMoveCursorRight(cc_Context* context, cc_type steps);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Move the cursor @p steps steps horizontally.
  *
@@ -254,6 +484,17 @@ void cc_moveCursorRight(cc_type steps);
  */
 void cc_moveCursorHorizontally(cc_type steps);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_moveCursorHorizontally, on the console of @p
+ *             context.
+ *
+ * @param      context  The context
+ * @param[in]  steps    The steps
+ *
+ * @since      0.4
+ */
+void cc_contextMoveCursorHorizontally(cc_Context* context, cc_type steps);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Move the cursor @p steps steps vertically.
  *
@@ -263,6 +504,16 @@ void cc_moveCursorHorizontally(cc_type steps);
  */
 void cc_moveCursorVertically(cc_type steps);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_moveCursorVertically, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  steps    The steps
+ *
+ * @since      0.4
+ */
+void cc_contextMoveCursorVertically(cc_Context* context, cc_type steps);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Move the cursor.
  *
@@ -272,6 +523,16 @@ void cc_moveCursorVertically(cc_type steps);
  */
 void cc_moveCursor(cc_Vector2 move);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_moveCursor, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  move     The move
+ *
+ * @since      0.4
+ */
+void cc_contextMoveCursor(cc_Context* context, cc_Vector2 move);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Save the cursor position.
  *
@@ -279,6 +540,15 @@ void cc_moveCursor(cc_Vector2 move);
  */
 void cc_saveCursorPosition();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_saveCursorPosition, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextSaveCursorPosition(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Restore the cursor position.
  *
@@ -286,6 +556,16 @@ void cc_saveCursorPosition();
  */
 void cc_restoreCursorPosition();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_restoreCursorPosition, on the console of @p
+ *             context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextRestoreCursorPosition(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set the cursor visibility.
  *
@@ -295,6 +575,108 @@ void cc_restoreCursorPosition();
  */
 void cc_setCursorVisibility(bool visibility);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_setCursorVisibility, on the console of @p context.
+ *
+ * @param      context     The context
+ * @param[in]  visibility  True for visible, false for not visible
+ *
+ * @since      0.4
+ */
+void cc_contextSetCursorVisibility(cc_Context* context, bool visibility);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set if the outputs must be wrapped in synchronized updates.
+ *
+ * @details    During a synchronized update the console keeps presenting the
+ *             previous frame, the new frame is presented at once at the end of
+ *             the update, without tearing. When enabled, the console support is
+ *             detected (see @c cc_isSynchronizedOutputSupported), if not
+ *             supported the outputs are sent without wrapping. Default value:
+ *             false.
+ *
+ * @param[in]  enabled  True for enabled, false for disabled
+ *
+ * @since      0.4
+ */
+void cc_setSynchronizedOutput(bool enabled);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_setSynchronizedOutput, on the console of @p
+ *             context.
+ *
+ * @param      context  The context
+ * @param[in]  enabled  True for enabled, false for disabled
+ *
+ * @since      0.4
+ */
+void cc_contextSetSynchronizedOutput(cc_Context* context, bool enabled);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Check if the console supports synchronized updates.
+ *
+ * @details    On Unix the terminal is queried once (DECRQM, mode 2026), the
+ *             inputs waiting at that moment can be lost.
+ *
+ * @return     True if the console supports synchronized updates, false
+ *             otherwise
+ *
+ * @since      0.4
+ */
+bool cc_isSynchronizedOutputSupported();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_isSynchronizedOutputSupported, on the console of @p
+ *             context.
+ *
+ * @param      context  The context
+ *
+ * @return     True if the console supports synchronized updates, false
+ *             otherwise
+ *
+ * @since      0.4
+ */
+bool cc_contextIsSynchronizedOutputSupported(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Begin a synchronized update, if enabled with @c
+ *             cc_setSynchronizedOutput.
+ *
+ * @details    Updates can be nested, only the outermost one is sent to the
+ *             console.
+ *
+ * @since      0.4
+ */
+void cc_beginSynchronizedUpdate();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_beginSynchronizedUpdate, on the console of @p
+ *             context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextBeginSynchronizedUpdate(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      End a synchronized update started with @c
+ *             cc_beginSynchronizedUpdate and send the outputs to the console.
+ *
+ * @since      0.4
+ */
+void cc_endSynchronizedUpdate();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_endSynchronizedUpdate, on the console of @p
+ *             context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextEndSynchronizedUpdate(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Clamp down the position in the console window.
  *
@@ -306,6 +688,18 @@ void cc_setCursorVisibility(bool visibility);
  */
 cc_Vector2 cc_clamp(cc_Vector2 position);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_clamp, on the console of @p context.
+ *
+ * @param      context   The context
+ * @param[in]  position  The position
+ *
+ * @return     The position clamped down in the console window
+ *
+ * @since      0.4
+ */
+cc_Vector2 cc_contextClamp(cc_Context* context, cc_Vector2 position);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Clamp down the x coordinate in the console window.
  *
@@ -317,6 +711,18 @@ cc_Vector2 cc_clamp(cc_Vector2 position);
  */
 cc_type cc_clampX(cc_type x);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_clampX, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  x        The x coordinate
+ *
+ * @return     The x coordinate clamped down in the console window
+ *
+ * @since      0.4
+ */
+cc_type cc_contextClampX(cc_Context* context, cc_type x);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Clamp down the y coordinate in the console window.
  *
@@ -328,6 +734,18 @@ cc_type cc_clampX(cc_type x);
  */
 cc_type cc_clampY(cc_type y);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_clampY, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  y        The y coordinate
+ *
+ * @return     The y coordinate clamped down in the console window
+ *
+ * @since      0.4
+ */
+cc_type cc_contextClampY(cc_Context* context, cc_type y);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Determine if the console window contains the position
  *
@@ -339,6 +757,18 @@ cc_type cc_clampY(cc_type y);
  */
 bool cc_contains(cc_Vector2 position);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_contains, on the console of @p context.
+ *
+ * @param      context   The context
+ * @param[in]  position  The position
+ *
+ * @return     True if the console window contains the position, false otherwise
+ *
+ * @since      0.4
+ */
+bool cc_contextContains(cc_Context* context, cc_Vector2 position);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Clean the console windows.
  *
@@ -346,6 +776,15 @@ bool cc_contains(cc_Vector2 position);
  */
 void cc_clean();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_clean, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextClean(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Clean the complete console.
  *
@@ -353,6 +792,116 @@ void cc_clean();
  */
 void cc_completeClean();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_completeClean, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextCompleteClean(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Scroll the lines @p top to @p bottom (inclusive) of the console
+ *             window by @p n lines, without moving the cursor.
+ *
+ * @details    A positive @p n scrolls the content up (the @p n lines at the
+ *             bottom of the region are exposed), a negative @p n scrolls the
+ *             content down (the @p n lines at the top of the region are
+ *             exposed). The exposed lines are cleared, only them need to be
+ *             drawn again. Lines outside of the region are not modified.
+ *
+ *             On Unix the scrolling region (DECSTBM) stay set after the call,
+ *             so scrolling the same region again only send the scroll
+ *             sequence, use @c cc_resetScrollRegion to reset it.
+ *
+ *             On Unix setting the scrolling region moves the cursor, its
+ *             position is kept with the save / restore sequences used by @c
+ *             cc_saveCursorPosition: a position saved before is lost when the
+ *             region is set.
+ *
+ * @param[in]  top     The first line of the region
+ * @param[in]  bottom  The last line of the region
+ * @param[in]  n       The number of lines to scroll
+ *
+ * @since      0.4
+ */
+void cc_scrollRegion(cc_type top, cc_type bottom, cc_type n);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_scrollRegion, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  top      The first line of the region
+ * @param[in]  bottom   The last line of the region
+ * @param[in]  n        The number of lines to scroll
+ *
+ * @since      0.4
+ */
+void cc_contextScrollRegion(cc_Context* context, cc_type top, cc_type bottom, cc_type n);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Reset the scrolling region set by @c cc_scrollRegion to the
+ *             whole console window, without moving the cursor.
+ *
+ * @details    On Unix, if a region was set, a cursor position saved with @c
+ *             cc_saveCursorPosition is lost, as when the region is set by @c
+ *             cc_scrollRegion.
+ *
+ * @since      0.4
+ */
+void cc_resetScrollRegion();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_resetScrollRegion, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextResetScrollRegion(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Switch to the alternate screen, a cleared screen without
+ *             scrollback.
+ *
+ * @details    The content of the console window and the cursor position are
+ *             kept, they are restored by @c cc_leaveAlternateScreen without
+ *             being redrawn. Calls can be nested, only the outermost call
+ *             switches the screen. The UI elements display themselves in the
+ *             alternate screen.
+ *
+ * @since      0.4
+ */
+void cc_enterAlternateScreen();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_enterAlternateScreen, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextEnterAlternateScreen(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Switch back from the alternate screen entered with @c
+ *             cc_enterAlternateScreen, restoring the previous content of the
+ *             console window and the cursor position.
+ *
+ * @since      0.4
+ */
+void cc_leaveAlternateScreen();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_leaveAlternateScreen, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextLeaveAlternateScreen(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Instantly get an inputed char without waiting a carriage return.
  *
@@ -362,6 +911,17 @@ void cc_completeClean();
  */
 char cc_instantGetChar();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_instantGetChar, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The char
+ *
+ * @since      0.4
+ */
+char cc_contextInstantGetChar(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Check if an input if waiting.
  *
@@ -373,6 +933,17 @@ char cc_instantGetChar();
  */
 bool cc_waitingInput();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_waitingInput, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     True if an input if waiting, false otherwise.
+ *
+ * @since      0.4
+ */
+bool cc_contextWaitingInput(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set if the inputs must be displayed or not.
  *
@@ -382,6 +953,16 @@ bool cc_waitingInput();
  */
 void cc_displayInputs(bool display);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_displayInputs, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  display  True for display, false for no display
+ *
+ * @since      0.4
+ */
+void cc_contextDisplayInputs(cc_Context* context, bool display);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Get an input. Blocking function.
  *
@@ -391,6 +972,17 @@ void cc_displayInputs(bool display);
  */
 cc_Input cc_getInput();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_getInput, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The input
+ *
+ * @since      0.4
+ */
+cc_Input cc_contextGetInput(cc_Context* context);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Print a character in place, without moving the cursor.
  *
@@ -400,6 +992,16 @@ cc_Input cc_getInput();
  */
 void cc_printInPlace(char c);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_printInPlace, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param[in]  c        The character to print
+ *
+ * @since      0.4
+ */
+void cc_contextPrintInPlace(cc_Context* context, char c);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Get the character associated with the key.
  *
@@ -0,0 +1,147 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+/**
+ * @file ConsoleControlLogPane.h
+ * @brief      Definition of ConsoleControl log pane related functions.
+ * @details    A log pane is a log sink (see @c lg_setLogSink) keeping the
+ *             last logs in a ring buffer and displaying them in a layer of a
+ *             screen (see @c cc_Layer): the logs of an application are read
+ *             in a reserved region of its UI, or in a layer shown on demand,
+ *             instead of being written to the console the UI is drawn on. The
+ *             logging threads only copy the logs in the ring buffer, the layer
+ *             is updated by the thread drawing the screen, for the logs
+ *             received since the previous update. Unix only.
+ * @author     Maxime Pinard
+ *
+ * @since      0.4
+ */
+
+#ifndef CONSOLECONTROL_CONSOLECONTROLLOGPANE_H
+#define CONSOLECONTROL_CONSOLECONTROLLOGPANE_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <log.h>
+#include <ConsoleControl.h>
+#include <ConsoleControlScreen.h>
+
+#ifndef OS_WINDOWS
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Log pane, last logs displayed in a layer.
+ *
+ * @since      0.4
+ */
+typedef struct cc_LogPane cc_LogPane;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Create a log pane, displaying the logs in a layer.
+ *
+ * @details    Each log is displayed on a line of the layer, the newest at the
+ *             bottom, cut at the layer width. The warnings are displayed in
+ *             yellow, the errors in red. The pane receives the logs once its
+ *             sink is set (see @c cc_logPaneGetSink).
+ *
+ * @param      layer           The layer, must stay valid while the pane
+ *                             exists
+ * @param[in]  recordsNumber   The number of logs kept, at least the layer
+ *                             height to scroll back in the older logs
+ *
+ * @return     The log pane, NULL if the creation failed
+ *
+ * @since      0.4
+ */
+cc_LogPane* cc_createLogPane(cc_Layer* layer, unsigned int recordsNumber);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Destroy a log pane.
+ *
+ * @details    Its sink must have been replaced before, with no log being
+ *             given to it. The layer is not destroyed.
+ *
+ * @param      pane  The log pane
+ *
+ * @since      0.4
+ */
+void cc_destroyLogPane(cc_LogPane* pane);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the log sink of a log pane, to give to @c lg_setLogSink.
+ *
+ * @param[in]  pane  The log pane
+ *
+ * @return     The log sink, valid while the pane exists
+ *
+ * @since      0.4
+ */
+const lg_LogSink* cc_logPaneGetSink(const cc_LogPane* pane);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Scroll a log pane back in the older logs.
+ *
+ * @details    The layer is updated by the next call to @c cc_logPaneUpdate.
+ *
+ * @param      pane    The log pane
+ * @param[in]  offset  The number of logs between the newest log and the log
+ *                     displayed at the bottom, 0 to follow the new logs
+ *
+ * @since      0.4
+ */
+void cc_logPaneSetScroll(cc_LogPane* pane, unsigned int offset);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Display the logs received since the previous update in the
+ *             layer of a log pane.
+ *
+ * @details    Only the new lines are drawn, the displayed lines are moved up
+ *             in the layer. Call it from the thread drawing the screen,
+ *             before flushing or presenting it.
+ *
+ * @param      pane  The log pane
+ *
+ * @return     true if the layer was modified, false otherwise
+ *
+ * @since      0.4
+ */
+bool cc_logPaneUpdate(cc_LogPane* pane);
+
+#endif //OS_WINDOWS
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //CONSOLECONTROL_CONSOLECONTROLLOGPANE_H
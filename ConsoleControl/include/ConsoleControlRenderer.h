@@ -0,0 +1,211 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+/**
+ * @file ConsoleControlRenderer.h
+ * @brief      Definition of ConsoleControl renderer related functions.
+ * @details    A renderer owns a screen (see @c cc_Screen) and a render thread:
+ *             the other threads submit drawing commands, the render thread
+ *             applies them to the screen and presents the frames. Submitting
+ *             is only a lock-free enqueue, the producers never wait for the
+ *             console, and only the render thread writes to it, the escape
+ *             sequences of several threads are not interleaved. A thread
+ *             owning a region of the screen (a panel) can also record its
+ *             commands in a thread-local buffer, submitted at once at the end
+ *             of its frame. Unix only.
+ * @author     Maxime Pinard
+ *
+ * @since      0.4
+ */
+
+#ifndef CONSOLECONTROL_CONSOLECONTROLRENDERER_H
+#define CONSOLECONTROL_CONSOLECONTROLRENDERER_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <log.h>
+#include <ConsoleControl.h>
+#include <ConsoleControlScreen.h>
+
+#ifndef OS_WINDOWS
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Renderer, render thread drawing the submitted commands on a
+ *             screen.
+ *
+ * @since      0.4
+ */
+typedef struct cc_Renderer cc_Renderer;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Type of a drawing command.
+ *
+ * @since      0.4
+ */
+typedef enum {
+	SET_CELL_COMMAND, /**< Set the cell at @c position to @c cell */
+	FILL_COMMAND, /**< Fill the rectangle from @c position to @c end with @c cell */
+	TEXT_COMMAND, /**< Write @c text from @c position (one cell per byte, cut at the screen
+	               * border), with the colors and attributes of @c cell */
+	CALL_COMMAND, /**< Call @c function with the screen and @c data, on the render thread */
+	FRAME_COMMAND /**< End of a frame, the screen is presented (once for the frames ended while the
+	               * render thread was busy) */
+} cc_CommandType;
+
+/*-------------------------------------------------------------------------*//**
+ * @struct cc_Command
+ *
+ * @brief      Drawing command submitted to a renderer, the fields not used by
+ *             the command type are ignored.
+ *
+ * @since      0.4
+ */
+typedef struct {
+	cc_CommandType type; /**< Type of the command */
+	cc_Vector2 position; /**< Position of the cell / top left corner of the rectangle / start of the text */
+	cc_Vector2 end; /**< Down right corner of the rectangle */
+	cc_PackedCell cell; /**< Cell set, its code point is ignored for a text */
+	const char* text; /**< Text written, copied when the command is submitted */
+	void (* function)(cc_Screen* screen, void* data); /**< Function called */
+	void* data; /**< Data given to the function */
+} cc_Command;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Create a renderer and start its render thread.
+ *
+ * @details    Once the renderer is created, the screen and the console of the
+ *             context must only be used by the render thread (through the
+ *             call commands) until the renderer is destroyed. The frames are
+ *             presented with @c cc_contextScreenPresent: if the console output
+ *             is non-blocking (see @c cc_contextSetNonBlockingOutput), the
+ *             frames a slow console is late for are skipped and the last
+ *             state is presented as soon as possible.
+ *
+ * @param      context  The context of the console, NULL for the default
+ *                      context
+ * @param      screen   The screen the commands are drawn on
+ *
+ * @return     The renderer, NULL if the creation failed
+ *
+ * @since      0.4
+ */
+cc_Renderer* cc_createRenderer(cc_Context* context, cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Destroy a renderer, after the render thread applied the
+ *             commands submitted and presented the screen.
+ *
+ * @details    No command must be submitted during or after the call, the
+ *             screen and the context are not destroyed.
+ *
+ * @param      renderer  The renderer
+ *
+ * @since      0.4
+ */
+void cc_destroyRenderer(cc_Renderer* renderer);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Submit a drawing command to a renderer.
+ *
+ * @details    Can be called by any thread without locking, the command is
+ *             copied (with its text) and applied later by the render thread.
+ *             The commands of one thread are applied in the order they were
+ *             submitted.
+ *
+ * @param      renderer  The renderer
+ * @param[in]  command   The command
+ *
+ * @return     true if the command was submitted, false if the allocation
+ *             failed
+ *
+ * @since      0.4
+ */
+bool cc_submit(cc_Renderer* renderer, const cc_Command* command);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Begin recording a frame of a region of the screen in the
+ *             command buffer of the calling thread.
+ *
+ * @details    The commands recorded with @c cc_record are drawn clipped to
+ *             the region (except the call commands), the command buffer is
+ *             owned by the thread: recording does not contend with the other
+ *             threads. A frame previously begun and not ended is discarded.
+ *
+ * @param      renderer   The renderer
+ * @param[in]  topLeft    The top left corner of the region
+ * @param[in]  downRight  The down right corner of the region
+ *
+ * @since      0.4
+ */
+void cc_beginFrame(cc_Renderer* renderer, cc_Vector2 topLeft, cc_Vector2 downRight);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Record a drawing command in the command buffer of the calling
+ *             thread.
+ *
+ * @details    The command is copied (with its text), the frame commands are
+ *             ignored.
+ *
+ * @param[in]  command  The command
+ *
+ * @return     true if the command was recorded, false if no frame was begun
+ *             by the thread or the allocation failed
+ *
+ * @since      0.4
+ */
+bool cc_record(const cc_Command* command);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      End the frame begun by the calling thread.
+ *
+ * @details    The recorded commands are submitted to the renderer at once,
+ *             followed by a frame command: the render thread applies them
+ *             together and presents the screen, with the frames ended by the
+ *             other threads meanwhile.
+ *
+ * @return     true if the frame was submitted, false if no frame was begun by
+ *             the thread or the allocation failed
+ *
+ * @since      0.4
+ */
+bool cc_endFrame();
+
+#endif //OS_WINDOWS
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //CONSOLECONTROL_CONSOLECONTROLRENDERER_H
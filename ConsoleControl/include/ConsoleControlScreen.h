@@ -0,0 +1,653 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+/**
+ * @file ConsoleControlScreen.h
+ * @brief      Definition of ConsoleControl off-screen buffer related functions.
+ * @details    A screen is drawn off-screen then flushed, only the differences
+ *             with the previously flushed frame are sent to the console. Layers
+ *             can be stacked over the screen cells (popups, tooltips, status
+ *             bars...), they are composited when flushing, only where the
+ *             screen cells or the layers changed.
+ * @author     Maxime Pinard
+ *
+ * @since      0.4
+ */
+
+#ifndef CONSOLECONTROL_CONSOLECONTROLSCREEN_H
+#define CONSOLECONTROL_CONSOLECONTROLSCREEN_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <log.h>
+#include <ConsoleControl.h>
+#include <ConsoleControlColor.h>
+
+/*-------------------------------------------------------------------------*//**
+ * @struct cc_Cell
+ *
+ * @brief      Definition of a screen cell.
+ *
+ * @details    The character is taken as a code point from 0 to 255, see @c
+ *             cc_PackedCell for the other code points and the attributes.
+ *
+ * @since      0.4
+ */
+typedef struct {
+	char ch; /**< Character of the cell, in a layer '\\0' for a transparent cell */
+	cc_Color backgroundColor; /**< Background color of the cell */
+	cc_Color foregroundColor; /**< Foreground color of the cell */
+} cc_Cell;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Packed screen cell, 4 bytes: Unicode code point (bits 0 to 20),
+ *             background color (bits 21 to 24), foreground color (bits 25 to
+ *             28) and attributes (bits 29 to 31).
+ *
+ * @details    Use @c cc_packCell to create a packed cell and the @c cc_cell*
+ *             accessors to read it. The screens store their cells packed, a
+ *             code point is displayed in one console cell.
+ *
+ * @since      0.4
+ */
+typedef uint32_t cc_PackedCell;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Attributes of a packed cell, can be combined.
+ *
+ * @details    The attributes are not rendered on Windows.
+ *
+ * @since      0.4
+ */
+typedef enum {
+	NO_ATTRIBUTE = 0x0, /**< No attribute */
+	BOLD_ATTRIBUTE = 0x1, /**< Bold */
+	UNDERLINE_ATTRIBUTE = 0x2, /**< Underline */
+	REVERSE_ATTRIBUTE = 0x4 /**< Reverse video */
+} cc_CellAttribute;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Pack a cell.
+ *
+ * @param[in]  codepoint        The Unicode code point (0 for a transparent
+ *                              cell in a layer)
+ * @param[in]  backgroundColor  The background color
+ * @param[in]  foregroundColor  The foreground color
+ * @param[in]  attributes       The attributes (combination of @c
+ *                              cc_CellAttribute)
+ *
+ * @return     The packed cell
+ *
+ * @since      0.4
+ */
+static inline cc_PackedCell cc_packCell(uint32_t codepoint, cc_Color backgroundColor, cc_Color foregroundColor,
+                                        unsigned int attributes) {
+	return (codepoint & 0x1FFFFFu)
+	       | (cc_PackedCell) backgroundColor << 21
+	       | (cc_PackedCell) foregroundColor << 25
+	       | (cc_PackedCell) (attributes & 0x7u) << 29;
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the code point of a packed cell.
+ *
+ * @param[in]  cell  The packed cell
+ *
+ * @return     The Unicode code point
+ *
+ * @since      0.4
+ */
+static inline uint32_t cc_cellCodepoint(cc_PackedCell cell) {
+	return cell & 0x1FFFFFu;
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the background color of a packed cell.
+ *
+ * @param[in]  cell  The packed cell
+ *
+ * @return     The background color
+ *
+ * @since      0.4
+ */
+static inline cc_Color cc_cellBackgroundColor(cc_PackedCell cell) {
+	return (cc_Color) (cell >> 21 & 0xFu);
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the foreground color of a packed cell.
+ *
+ * @param[in]  cell  The packed cell
+ *
+ * @return     The foreground color
+ *
+ * @since      0.4
+ */
+static inline cc_Color cc_cellForegroundColor(cc_PackedCell cell) {
+	return (cc_Color) (cell >> 25 & 0xFu);
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the attributes of a packed cell.
+ *
+ * @param[in]  cell  The packed cell
+ *
+ * @return     The attributes (combination of @c cc_CellAttribute)
+ *
+ * @since      0.4
+ */
+static inline unsigned int cc_cellAttributes(cc_PackedCell cell) {
+	return (unsigned int) (cell >> 29);
+}
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Decode the UTF-8 character at the start of a text.
+ *
+ * @details    An invalid sequence (truncated, overlong, surrogate...) is
+ *             decoded as one U+FFFD replacement character per byte.
+ *
+ * @param[in]  bytes      The text, at least one byte
+ * @param[in]  length     The number of bytes of the text
+ * @param[out] codepoint  The Unicode code point of the character
+ *
+ * @return     The number of bytes of the character
+ *
+ * @since      0.4
+ */
+size_t cc_decodeCodepoint(const char* bytes, size_t length, uint32_t* codepoint);
+
+/*-------------------------------------------------------------------------*//**
+ * @struct cc_Screen
+ *
+ * @brief      Off-screen buffer, drawn at the top left corner of the console
+ *             window.
+ *
+ * @since      0.4
+ */
+typedef struct cc_Screen cc_Screen;
+
+/*-------------------------------------------------------------------------*//**
+ * @struct cc_Layer
+ *
+ * @brief      Layer of cells displayed over the cells of a screen, and over
+ *             the layers of the screen with a lower z-order.
+ *
+ * @since      0.4
+ */
+typedef struct cc_Layer cc_Layer;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Create a screen, filled with spaces (black background, white
+ *             foreground).
+ *
+ * @details    The first flush draws the complete screen.
+ *
+ * @param[in]  width   The width
+ * @param[in]  height  The height
+ *
+ * @return     The screen, NULL on failure
+ *
+ * @since      0.4
+ */
+cc_Screen* cc_createScreen(cc_type width, cc_type height);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Destroy a screen and its layers.
+ *
+ * @param      screen  The screen
+ *
+ * @since      0.4
+ */
+void cc_destroyScreen(cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the screen width.
+ *
+ * @param[in]  screen  The screen
+ *
+ * @return     The screen width
+ *
+ * @since      0.4
+ */
+cc_type cc_getScreenWidth(const cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the screen height.
+ *
+ * @param[in]  screen  The screen
+ *
+ * @return     The screen height
+ *
+ * @since      0.4
+ */
+cc_type cc_getScreenHeight(const cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set a cell of the screen, positions out of the screen are
+ *             ignored.
+ *
+ * @param      screen    The screen
+ * @param[in]  position  The position
+ * @param[in]  cell      The cell
+ *
+ * @since      0.4
+ */
+void cc_screenSetCell(cc_Screen* screen, cc_Vector2 position, cc_Cell cell);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get a cell of the screen.
+ *
+ * @param[in]  screen    The screen
+ * @param[in]  position  The position
+ *
+ * @return     The cell (under the layers), a space cell for positions out of
+ *             the screen, '?' character for the code points greater than 255
+ *
+ * @since      0.4
+ */
+cc_Cell cc_screenGetCell(const cc_Screen* screen, cc_Vector2 position);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set a packed cell of the screen, positions out of the screen are
+ *             ignored.
+ *
+ * @param      screen    The screen
+ * @param[in]  position  The position
+ * @param[in]  cell      The packed cell
+ *
+ * @since      0.4
+ */
+void cc_screenSetPackedCell(cc_Screen* screen, cc_Vector2 position, cc_PackedCell cell);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get a packed cell of the screen.
+ *
+ * @param[in]  screen    The screen
+ * @param[in]  position  The position
+ *
+ * @return     The packed cell (under the layers), a space cell for positions
+ *             out of the screen
+ *
+ * @since      0.4
+ */
+cc_PackedCell cc_screenGetPackedCell(const cc_Screen* screen, cc_Vector2 position);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Print a text on the screen, the part of the text out of the
+ *             screen is ignored.
+ *
+ * @param      screen           The screen
+ * @param[in]  position         Position of the first character
+ * @param[in]  text             The text in UTF-8, one cell per character
+ *                              (without '\\n' or '\\r')
+ * @param[in]  backgroundColor  The background color
+ * @param[in]  foregroundColor  The foreground color
+ *
+ * @since      0.4
+ */
+void cc_screenPrint(cc_Screen* screen, cc_Vector2 position, const char* text, cc_Color backgroundColor,
+                    cc_Color foregroundColor);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Fill a rectangle of the screen with a cell.
+ *
+ * @param      screen     The screen
+ * @param[in]  topLeft    Position of the top left corner of the rectangle
+ * @param[in]  downRight  Position of the down right corner of the rectangle
+ * @param[in]  cell       The cell
+ *
+ * @since      0.4
+ */
+void cc_screenFill(cc_Screen* screen, cc_Vector2 topLeft, cc_Vector2 downRight, cc_Cell cell);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set if the vertical moves of lines must be detected and sent as
+ *             scrolls when flushing.
+ *
+ * @details    Lines are compared with hashes, blocks of lines moved up or down
+ *             since the last flush are scrolled with @c cc_scrollRegion before
+ *             the remaining differences are sent. Scrolling moves complete
+ *             lines of the console, the detection is only used when the screen
+ *             is as wide as the console window. The scrolling region is reset
+ *             at the end of the flush. On Unix, a flush which scrolls loses a
+ *             cursor position saved with @c cc_saveCursorPosition (see @c
+ *             cc_scrollRegion). Default value: true.
+ *
+ * @param      screen   The screen
+ * @param[in]  enabled  True for enabled, false for disabled
+ *
+ * @since      0.4
+ */
+void cc_screenSetScrollDetection(cc_Screen* screen, bool enabled);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Forget the content displayed by the console, the next flush
+ *             draws the complete screen.
+ *
+ * @details    To use when the console was modified without the screen (clean,
+ *             resize...).
+ *
+ * @param      screen  The screen
+ *
+ * @since      0.4
+ */
+void cc_screenInvalidate(cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Forget the content displayed by the console in a rectangle of
+ *             the screen, the next flush draws this rectangle again.
+ *
+ * @details    To use when a part of the console was drawn over without the
+ *             screen (popup, message...): flushing after restores only the
+ *             covered rectangle.
+ *
+ * @param      screen     The screen
+ * @param[in]  topLeft    Position of the top left corner of the rectangle
+ * @param[in]  downRight  Position of the down right corner of the rectangle
+ *
+ * @since      0.4
+ */
+void cc_screenInvalidateRegion(cc_Screen* screen, cc_Vector2 topLeft, cc_Vector2 downRight);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Send the differences between the screen and the last flushed
+ *             frame to the console.
+ *
+ * @details    The cursor position and the colors are modified. The outputs
+ *             are sent in a synchronized update (see @c
+ *             cc_beginSynchronizedUpdate).
+ *
+ * @param      screen  The screen
+ *
+ * @since      0.4
+ */
+void cc_screenFlush(cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_screenFlush, on the console of @p context.
+ *
+ * @details    The screen keeps the frame displayed by the console, it must
+ *             always be flushed on the same console.
+ *
+ * @param      context  The context
+ * @param      screen   The screen
+ *
+ * @since      0.4
+ */
+void cc_contextScreenFlush(cc_Context* context, cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Flush the screen, unless the console is late reading the
+ *             previous frames.
+ *
+ * @details    In non-blocking output mode (see @c cc_setNonBlockingOutput),
+ *             the frame is skipped while writing the pending outputs would
+ *             take longer than the maximal latency at the rate the console
+ *             reads (see @c cc_outputDrainRate): the frames nobody would see
+ *             are not sent. The next presented frame is sent as one diff from
+ *             the last frame sent, present again when the pending outputs are
+ *             written to send the last state. In blocking mode and on Windows,
+ *             the screen is always flushed.
+ *
+ * @param      screen  The screen
+ *
+ * @return     True if the frame was flushed, false if skipped
+ *
+ * @since      0.4
+ */
+bool cc_screenPresent(cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_screenPresent, on the console of @p context.
+ *
+ * @param      context  The context
+ * @param      screen   The screen
+ *
+ * @return     True if the frame was flushed, false if skipped
+ *
+ * @since      0.4
+ */
+bool cc_contextScreenPresent(cc_Context* context, cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the maximal time the pending outputs can take to be written
+ *             for a frame to be presented by @c cc_screenPresent. Default
+ *             value: 50 milliseconds.
+ *
+ * @param      screen        The screen
+ * @param[in]  milliseconds  The maximal latency in milliseconds
+ *
+ * @since      0.4
+ */
+void cc_screenSetMaxLatency(cc_Screen* screen, unsigned int milliseconds);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the number of frames skipped by @c cc_screenPresent.
+ *
+ * @param[in]  screen  The screen
+ *
+ * @return     The number of skipped frames
+ *
+ * @since      0.4
+ */
+unsigned long cc_screenGetSkippedFrames(const cc_Screen* screen);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Create a layer over a screen, filled with transparent cells and
+ *             visible.
+ *
+ * @details    The layers with the highest z-order are displayed over the
+ *             others, for a same z-order the last created layer is displayed
+ *             over the others.
+ *
+ * @param      screen    The screen
+ * @param[in]  position  Position of the top left corner of the layer in the
+ *                       screen (the layer can be partially out of the screen)
+ * @param[in]  width     The width
+ * @param[in]  height    The height
+ * @param[in]  z         The z-order
+ *
+ * @return     The layer, NULL on failure
+ *
+ * @since      0.4
+ */
+cc_Layer* cc_createLayer(cc_Screen* screen, cc_Vector2 position, cc_type width, cc_type height, int z);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Destroy a layer, removing it from its screen.
+ *
+ * @param      layer  The layer
+ *
+ * @since      0.4
+ */
+void cc_destroyLayer(cc_Layer* layer);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Move a layer.
+ *
+ * @param      layer     The layer
+ * @param[in]  position  Position of the top left corner of the layer in the
+ *                       screen
+ *
+ * @since      0.4
+ */
+void cc_layerSetPosition(cc_Layer* layer, cc_Vector2 position);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the position of a layer.
+ *
+ * @param[in]  layer  The layer
+ *
+ * @return     Position of the top left corner of the layer in the screen
+ *
+ * @since      0.4
+ */
+cc_Vector2 cc_layerGetPosition(const cc_Layer* layer);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the width of a layer.
+ *
+ * @param[in]  layer  The layer
+ *
+ * @return     The width
+ *
+ * @since      0.4
+ */
+cc_type cc_getLayerWidth(const cc_Layer* layer);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the height of a layer.
+ *
+ * @param[in]  layer  The layer
+ *
+ * @return     The height
+ *
+ * @since      0.4
+ */
+cc_type cc_getLayerHeight(const cc_Layer* layer);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the z-order of a layer.
+ *
+ * @param      layer  The layer
+ * @param[in]  z      The z-order
+ *
+ * @since      0.4
+ */
+void cc_layerSetZ(cc_Layer* layer, int z);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set if a layer is displayed.
+ *
+ * @param      layer    The layer
+ * @param[in]  visible  True for displayed, false for hidden
+ *
+ * @since      0.4
+ */
+void cc_layerSetVisible(cc_Layer* layer, bool visible);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set a cell of a layer, positions out of the layer are ignored.
+ *
+ * @param      layer     The layer
+ * @param[in]  position  The position, in the layer
+ * @param[in]  cell      The cell ('\\0' character for a transparent cell)
+ *
+ * @since      0.4
+ */
+void cc_layerSetCell(cc_Layer* layer, cc_Vector2 position, cc_Cell cell);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get a cell of a layer.
+ *
+ * @param[in]  layer     The layer
+ * @param[in]  position  The position, in the layer
+ *
+ * @return     The cell, a transparent cell for positions out of the layer
+ *
+ * @since      0.4
+ */
+cc_Cell cc_layerGetCell(const cc_Layer* layer, cc_Vector2 position);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set a packed cell of a layer, positions out of the layer are
+ *             ignored.
+ *
+ * @param      layer     The layer
+ * @param[in]  position  The position, in the layer
+ * @param[in]  cell      The packed cell (code point 0 for a transparent cell)
+ *
+ * @since      0.4
+ */
+void cc_layerSetPackedCell(cc_Layer* layer, cc_Vector2 position, cc_PackedCell cell);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get a packed cell of a layer.
+ *
+ * @param[in]  layer     The layer
+ * @param[in]  position  The position, in the layer
+ *
+ * @return     The packed cell, a transparent cell for positions out of the
+ *             layer
+ *
+ * @since      0.4
+ */
+cc_PackedCell cc_layerGetPackedCell(const cc_Layer* layer, cc_Vector2 position);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Print a text on a layer, the part of the text out of the layer
+ *             is ignored.
+ *
+ * @param      layer            The layer
+ * @param[in]  position         Position of the first character, in the layer
+ * @param[in]  text             The text in UTF-8, one cell per character
+ *                              (without '\\n' or '\\r')
+ * @param[in]  backgroundColor  The background color
+ * @param[in]  foregroundColor  The foreground color
+ *
+ * @since      0.4
+ */
+void cc_layerPrint(cc_Layer* layer, cc_Vector2 position, const char* text, cc_Color backgroundColor,
+                   cc_Color foregroundColor);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Fill a rectangle of a layer with a cell.
+ *
+ * @param      layer      The layer
+ * @param[in]  topLeft    Position of the top left corner of the rectangle, in
+ *                        the layer
+ * @param[in]  downRight  Position of the down right corner of the rectangle,
+ *                        in the layer
+ * @param[in]  cell       The cell
+ *
+ * @since      0.4
+ */
+void cc_layerFill(cc_Layer* layer, cc_Vector2 topLeft, cc_Vector2 downRight, cc_Cell cell);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Fill a layer with transparent cells.
+ *
+ * @param      layer  The layer
+ *
+ * @since      0.4
+ */
+void cc_layerClear(cc_Layer* layer);
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //CONSOLECONTROL_CONSOLECONTROLSCREEN_H
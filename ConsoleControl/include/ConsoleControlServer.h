@@ -0,0 +1,247 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+/**
+ * @file ConsoleControlServer.h
+ * @brief      Definition of ConsoleControl server related functions.
+ * @details    A server drives the sessions of many consoles (the
+ *             pseudo-terminals of remote users for example) from one thread:
+ *             the consoles inputs are waited with epoll, decoded per session
+ *             and dispatched to the session handler, each session having its
+ *             own context (see @c cc_Context). To use several cores, run one
+ *             server per thread. Linux only.
+ * @author     Maxime Pinard
+ *
+ * @since      0.4
+ */
+
+#ifndef CONSOLECONTROL_CONSOLECONTROLSERVER_H
+#define CONSOLECONTROL_CONSOLECONTROLSERVER_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <log.h>
+#include <ConsoleControl.h>
+#include <UnixConsoleControl.h>
+
+#ifdef __linux__
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Server driving the sessions of several consoles.
+ *
+ * @since      0.4
+ */
+typedef struct cc_Server cc_Server;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Session of a console driven by a server.
+ *
+ * @since      0.4
+ */
+typedef struct cc_Session cc_Session;
+
+/*-------------------------------------------------------------------------*//**
+ * @struct cc_SessionHandler
+ *
+ * @brief      Functions called by a server on the events of a session.
+ *
+ * @details    The functions are called with the context of the session as
+ *             current context (see @c cc_setCurrentContext), so the
+ *             ConsoleControl output functions can be used directly (text is
+ *             printed with fprintf on @c cc_getOutput). They must
+ *             not wait for inputs: the session state (menu choice, text
+ *             being edited...) is kept between the calls, in the session data
+ *             for example. The outputs are sent after the call, the outputs
+ *             written outside of the handler functions (frames presented on a
+ *             timer for example) are sent with @c cc_sessionFlush.
+ *
+ * @since      0.4
+ */
+typedef struct {
+	void (* open)(cc_Session* session); /**< Called when the session is added, can be NULL */
+	void (* input)(cc_Session* session, cc_Input input); /**< Called for each input of the console */
+	void (* close)(cc_Session* session); /**< Called when the session is removed (console input closed or
+	                                      * @c cc_serverRemoveSession called), can be NULL */
+	void (* drained)(cc_Session* session); /**< Called when the outputs pending for a slow console were all
+	                                        * written, to present the frames skipped meanwhile (see @c
+	                                        * cc_screenPresent), can be NULL */
+} cc_SessionHandler;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Create a server, without sessions.
+ *
+ * @return     The server, NULL if the creation failed
+ *
+ * @since      0.4
+ */
+cc_Server* cc_createServer();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Destroy a server, removing its sessions.
+ *
+ * @param      server  The server
+ *
+ * @since      0.4
+ */
+void cc_destroyServer(cc_Server* server);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Add the session of a console to the server.
+ *
+ * @details    A context is created for the console (see @c
+ *             cc_createContext). The input is set non blocking, non canonical
+ *             and without echo, the output non-blocking (see @c
+ *             cc_contextSetNonBlockingOutput): the outputs a slow console does
+ *             not accept are written when it becomes writable. The file
+ *             descriptors are restored when the session is removed but not
+ *             closed, they stay owned by the caller. The input functions of ConsoleControl must not be used
+ *             on the session context.
+ *
+ * @param      server    The server
+ * @param[in]  inputFd   The console input file descriptor
+ * @param[in]  outputFd  The console output file descriptor
+ * @param[in]  handler   The session handler, must stay valid while the
+ *                       session exists
+ * @param[in]  data      The session data, given back by @c cc_sessionGetData
+ *
+ * @return     The session, NULL if the creation failed or if the open function
+ *             of the handler removed the session
+ *
+ * @since      0.4
+ */
+cc_Session* cc_serverAddSession(cc_Server* server, int inputFd, int outputFd, const cc_SessionHandler* handler,
+                                void* data);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Remove a session from its server and destroy it, after calling
+ *             the close function of its handler.
+ *
+ * @details    Can be called from a handler function, the session is then
+ *             destroyed after the handler function returns.
+ *
+ * @param      session  The session
+ *
+ * @since      0.4
+ */
+void cc_serverRemoveSession(cc_Session* session);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Wait for the consoles inputs and dispatch them to the sessions
+ *             handlers.
+ *
+ * @details    All the inputs waiting are read and dispatched before
+ *             returning, the sessions which console closed its input are
+ *             removed. Call it in a loop to run the server. A key sequence
+ *             split between two reads is kept until its next bytes are read,
+ *             or decoded as separate keys after 100 milliseconds without them
+ *             (an escape key alone for example): the function then returns
+ *             before the timeout to decode it.
+ *
+ * @param      server   The server
+ * @param[in]  timeout  Maximal time to wait for inputs in milliseconds, -1 to
+ *                      wait forever, 0 to not wait
+ *
+ * @return     The number of sessions which received inputs, -1 on error
+ *
+ * @since      0.4
+ */
+int cc_serverRun(cc_Server* server, int timeout);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the number of sessions of the server.
+ *
+ * @param[in]  server  The server
+ *
+ * @return     The number of sessions
+ *
+ * @since      0.4
+ */
+unsigned int cc_serverGetSessionsNumber(const cc_Server* server);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the context of the session console.
+ *
+ * @param[in]  session  The session
+ *
+ * @return     The context
+ *
+ * @since      0.4
+ */
+cc_Context* cc_sessionGetContext(const cc_Session* session);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the data given when the session was added.
+ *
+ * @param[in]  session  The session
+ *
+ * @return     The session data
+ *
+ * @since      0.4
+ */
+void* cc_sessionGetData(const cc_Session* session);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the server of the session.
+ *
+ * @param[in]  session  The session
+ *
+ * @return     The server
+ *
+ * @since      0.4
+ */
+cc_Server* cc_sessionGetServer(const cc_Session* session);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Send the outputs written on the session context outside of its
+ *             handler functions.
+ *
+ * @details    The outputs the console does not accept are written by @c
+ *             cc_serverRun when it becomes writable, the drained function of
+ *             the handler is then called. Call it from the thread running the
+ *             server.
+ *
+ * @param      session  The session
+ *
+ * @since      0.4
+ */
+void cc_sessionFlush(cc_Session* session);
+
+#endif //__linux__
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //CONSOLECONTROL_CONSOLECONTROLSERVER_H
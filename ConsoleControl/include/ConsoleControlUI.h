@@ -27,6 +27,9 @@
 /**
  * @file ConsoleControlUI.h
  * @brief      Definition of ConsoleControl UI related functions.
+ * @details    The UI elements are displayed in the alternate screen (see @c
+ *             cc_enterAlternateScreen), the previous content of the console
+ *             window is back when they return.
  * @author     Maxime Pinard
  *
  * @since      0.1
@@ -48,6 +51,7 @@ extern "C" {
 #include <ConsoleControlMenu.h>
 #include <ConsoleControlInput.h>
 #include <ConsoleControlMessage.h>
+#include <ConsoleControlScreen.h>
 
 /*-------------------------------------------------------------------------*//**
  * @brief      Display the menu with the table style ('-' for horizontal lines,
@@ -106,6 +110,23 @@ void cc_displayColorMenu(cc_Menu* menu, const cc_MenuColors* colors);
  */
 void cc_displayTableMessage(cc_Message* message);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Display the message with the table style over the screen, as a
+ *             modal.
+ *
+ * @details    Same as @c cc_displayTableMessage but the console is not
+ *             cleaned and the alternate screen is not used: the message is
+ *             drawn over the content of the screen, which must be the last
+ *             flushed frame. When the message returns, only the part of the
+ *             screen covered by the message is drawn again.
+ *
+ * @param      message  The message description struct
+ * @param      screen   The screen displayed under the message
+ *
+ * @since      0.4
+ */
+void cc_displayTableModalMessage(cc_Message* message, cc_Screen* screen);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Display the message with the specified color style.
  *
@@ -127,6 +148,24 @@ void cc_displayTableMessage(cc_Message* message);
  */
 void cc_displayColorMessage(cc_Message* message, const cc_MessageColors* colors);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Display the message with the specified color style over the
+ *             screen, as a modal.
+ *
+ * @details    Same as @c cc_displayColorMessage but the console is not
+ *             cleaned and the alternate screen is not used: the message is
+ *             drawn over the content of the screen, which must be the last
+ *             flushed frame. When the message returns, only the part of the
+ *             screen covered by the message is drawn again.
+ *
+ * @param      message  The message description struct
+ * @param[in]  colors   The color style definition
+ * @param      screen   The screen displayed under the message
+ *
+ * @since      0.4
+ */
+void cc_displayColorModalMessage(cc_Message* message, const cc_MessageColors* colors, cc_Screen* screen);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Display the option menu with the table style ('-' for horizontal
  *             lines, '|' for vertical lines, '+' for angles and intersections).
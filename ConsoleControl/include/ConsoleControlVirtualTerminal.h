@@ -0,0 +1,287 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+/**
+ * @file ConsoleControlVirtualTerminal.h
+ * @brief      Definition of ConsoleControl virtual terminal related functions.
+ * @details    A virtual terminal is a headless terminal: a context writes its
+ *             outputs to a pseudo-terminal, they are interpreted by a thread
+ *             which maintains the terminal cells in memory, and the inputs
+ *             are given by the program. The UI elements and the screens can be
+ *             driven and measured without a console, and the cells displayed
+ *             by different output paths can be compared. The interpreted
+ *             sequences are the ones sent by the library and the usual VT100 /
+ *             xterm cursor, erase, scroll and graphic rendition sequences, the
+ *             mode requests (DECRQM) and the primary device attributes request
+ *             are replied to on the input, the other sequences are ignored.
+ *             Unix only.
+ * @author     Maxime Pinard
+ *
+ * @since      0.4
+ */
+
+#ifndef CONSOLECONTROL_CONSOLECONTROLVIRTUALTERMINAL_H
+#define CONSOLECONTROL_CONSOLECONTROLVIRTUALTERMINAL_H
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <log.h>
+#include <ConsoleControl.h>
+#include <ConsoleControlScreen.h>
+
+#ifndef OS_WINDOWS
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Virtual terminal, headless terminal keeping its cells in memory.
+ *
+ * @since      0.4
+ */
+typedef struct cc_VirtualTerminal cc_VirtualTerminal;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Create a virtual terminal, filled with spaces (black background,
+ *             white foreground).
+ *
+ * @details    The inputs are read unmodified and not echoed (raw mode of the
+ *             pseudo-terminal), the outputs new lines are converted as by a
+ *             console.
+ *
+ * @param[in]  width   The width
+ * @param[in]  height  The height
+ *
+ * @return     The virtual terminal, NULL if the creation failed
+ *
+ * @since      0.4
+ */
+cc_VirtualTerminal* cc_createVirtualTerminal(cc_type width, cc_type height);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Destroy a virtual terminal and its context.
+ *
+ * @details    The context must not be used anymore, nor be the current
+ *             context of another thread.
+ *
+ * @param      terminal  The virtual terminal
+ *
+ * @since      0.4
+ */
+void cc_destroyVirtualTerminal(cc_VirtualTerminal* terminal);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the context of a virtual terminal, its outputs are displayed
+ *             by the terminal and its inputs are the ones given to the
+ *             terminal.
+ *
+ * @param[in]  terminal  The virtual terminal
+ *
+ * @return     The context, valid while the terminal exists
+ *
+ * @since      0.4
+ */
+cc_Context* cc_virtualTerminalGetContext(const cc_VirtualTerminal* terminal);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the virtual terminal width.
+ *
+ * @param      terminal  The virtual terminal
+ *
+ * @return     The virtual terminal width
+ *
+ * @since      0.4
+ */
+cc_type cc_getVirtualTerminalWidth(cc_VirtualTerminal* terminal);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the virtual terminal height.
+ *
+ * @param      terminal  The virtual terminal
+ *
+ * @return     The virtual terminal height
+ *
+ * @since      0.4
+ */
+cc_type cc_getVirtualTerminalHeight(cc_VirtualTerminal* terminal);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Resize a virtual terminal.
+ *
+ * @details    The cells in the new size are kept, the others are lost, the
+ *             scrolling region is reset. The size of the pseudo-terminal is
+ *             changed and the context size is invalidated, as when a console
+ *             window is resized.
+ *
+ * @param      terminal  The virtual terminal
+ * @param[in]  width     The new width
+ * @param[in]  height    The new height
+ *
+ * @return     true if the terminal was resized, false otherwise
+ *
+ * @since      0.4
+ */
+bool cc_virtualTerminalResize(cc_VirtualTerminal* terminal, cc_type width, cc_type height);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Give inputs to a virtual terminal, as typed on a keyboard.
+ *
+ * @details    The inputs are read by the context in the given order. The
+ *             inputs given and not read yet are limited to the input buffer
+ *             of the pseudo-terminal (a few kilobytes), beyond the call waits
+ *             for the context to read them.
+ *
+ * @param      terminal  The virtual terminal
+ * @param[in]  bytes     The inputs bytes
+ * @param[in]  length    The number of bytes
+ *
+ * @return     true if the inputs were given, false otherwise
+ *
+ * @since      0.4
+ */
+bool cc_virtualTerminalInput(cc_VirtualTerminal* terminal, const char* bytes, size_t length);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Give a key input to a virtual terminal, as sent by a console
+ *             when the key is pressed.
+ *
+ * @details    A key following the escape key is read as part of an escape
+ *             sequence, give it once the escape key was read.
+ *
+ * @param      terminal  The virtual terminal
+ * @param[in]  key       The key, not @c OTHER_KEY
+ *
+ * @return     true if the input was given, false otherwise
+ *
+ * @since      0.4
+ */
+bool cc_virtualTerminalInputKey(cc_VirtualTerminal* terminal, cc_Key key);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Wait until a virtual terminal displayed all the outputs of its
+ *             context.
+ *
+ * @details    The context outputs are flushed, call it from the thread using
+ *             the context before reading the cells.
+ *
+ * @param      terminal  The virtual terminal
+ *
+ * @return     true if the outputs were displayed, false otherwise
+ *
+ * @since      0.4
+ */
+bool cc_virtualTerminalSync(cc_VirtualTerminal* terminal);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get a cell of a virtual terminal.
+ *
+ * @details    The cell is packed (see @c cc_PackedCell), the reverse
+ *             attribute is kept as an attribute, the colors are not swapped.
+ *
+ * @param      terminal  The virtual terminal
+ * @param[in]  position  The position of the cell
+ *
+ * @return     The cell, a space (black background, white foreground) if the
+ *             position is outside the terminal
+ *
+ * @since      0.4
+ */
+cc_PackedCell cc_virtualTerminalGetCell(cc_VirtualTerminal* terminal, cc_Vector2 position);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the text of a line of a virtual terminal.
+ *
+ * @details    The characters are written in UTF-8, without the trailing
+ *             spaces, followed by a '\\0'. The text is cut if the buffer is
+ *             too small.
+ *
+ * @param      terminal  The virtual terminal
+ * @param[in]  y         The line
+ * @param[out] buffer    The buffer receiving the text
+ * @param[in]  size      The buffer size
+ *
+ * @return     The text length, without the '\\0'
+ *
+ * @since      0.4
+ */
+size_t cc_virtualTerminalGetText(cc_VirtualTerminal* terminal, cc_type y, char* buffer, size_t size);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the cursor position of a virtual terminal.
+ *
+ * @param      terminal  The virtual terminal
+ *
+ * @return     The cursor position
+ *
+ * @since      0.4
+ */
+cc_Vector2 cc_virtualTerminalGetCursorPosition(cc_VirtualTerminal* terminal);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the number of bytes a virtual terminal received from its
+ *             context.
+ *
+ * @param      terminal  The virtual terminal
+ *
+ * @return     The number of bytes received since the creation
+ *
+ * @since      0.4
+ */
+unsigned long long cc_virtualTerminalGetReceivedBytes(cc_VirtualTerminal* terminal);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Find the first cell different between two virtual terminals.
+ *
+ * @details    Used to check that two output paths display the same result.
+ *             The cells are compared line by line, terminals of different
+ *             sizes are different at the position (0, 0).
+ *
+ * @param      terminal       The first virtual terminal
+ * @param      otherTerminal  The second virtual terminal
+ * @param[out] position       The position of the first different cell, can
+ *                            be NULL
+ *
+ * @return     true if a different cell was found, false if the terminals
+ *             display the same cells
+ *
+ * @since      0.4
+ */
+bool cc_virtualTerminalFindDifference(cc_VirtualTerminal* terminal, cc_VirtualTerminal* otherTerminal,
+                                      cc_Vector2* position);
+
+#endif //OS_WINDOWS
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif //CONSOLECONTROL_CONSOLECONTROLVIRTUALTERMINAL_H
@@ -64,6 +64,225 @@ extern "C" {
  */
 void cc_permanentReverseColors();
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_permanentReverseColors, on the console of @p
+ *             context.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextPermanentReverseColors(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Create a context controlling the console of the given file
+ *             descriptors, a pseudo-terminal for example.
+ *
+ * @details    The file descriptors are duplicated, they stay owned by the
+ *             caller. The outputs are fully buffered, they are sent at the end
+ *             of the synchronized updates (see @c
+ *             cc_contextEndSynchronizedUpdate), before waiting for an input or
+ *             with fflush on @c cc_contextGetOutput. The console size is
+ *             cached, call @c cc_contextInvalidateSize when the console is
+ *             resized. The console mode is restored by @c cc_destroyContext.
+ *
+ * @param[in]  inputFd   The input file descriptor
+ * @param[in]  outputFd  The output file descriptor
+ *
+ * @return     The context, NULL if the creation failed
+ *
+ * @since      0.4
+ */
+cc_Context* cc_createContext(int inputFd, int outputFd);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Destroy a context created with @c cc_createContext, sending its
+ *             waiting outputs and restoring the console mode.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_destroyContext(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Notify the context that its console was resized, the size is
+ *             queried again on next use.
+ *
+ * @details    Async-signal-safe, can be called from a SIGWINCH handler.
+ *
+ * @param      context  The context
+ *
+ * @since      0.4
+ */
+void cc_contextInvalidateSize(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the size of the console of the context instead of querying
+ *             it.
+ *
+ * @details    For the outputs which are not terminals (file, pipe, /dev/null),
+ *             which size cannot be queried.
+ *
+ * @param      context  The context
+ * @param[in]  width    The width, 0 to query the console size again
+ * @param[in]  height   The height, 0 to query the console size again
+ *
+ * @since      0.4
+ */
+void cc_contextSetSize(cc_Context* context, cc_type width, cc_type height);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set if the outputs must be written without blocking.
+ *
+ * @details    In non-blocking mode the output file is set non-blocking, the
+ *             outputs are printed in memory and written when flushed (see @c
+ *             cc_flushOutput), the bytes the console does not accept yet are
+ *             queued, so a console which does not read its outputs never
+ *             blocks the process. The waiting inputs are still read with the
+ *             input functions. Disabling the mode writes the queued bytes,
+ *             blocking. The text must be printed with fprintf on @c
+ *             cc_getOutput. The non-blocking flag is set on the open file
+ *             description: every file descriptor sharing it is non-blocking
+ *             too (on a terminal, usually stdin, stderr, where the logs are
+ *             written by default, and the parent shell), until the mode is
+ *             disabled. For the default context it is disabled at exit.
+ *             Default value: false.
+ *
+ * @param[in]  nonBlocking  True for non-blocking, false for blocking
+ *
+ * @since      0.4
+ */
+void cc_setNonBlockingOutput(bool nonBlocking);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_setNonBlockingOutput, on the console of @p
+ *             context.
+ *
+ * @param      context      The context
+ * @param[in]  nonBlocking  True for non-blocking, false for blocking
+ *
+ * @since      0.4
+ */
+void cc_contextSetNonBlockingOutput(cc_Context* context, bool nonBlocking);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Send the outputs to the console.
+ *
+ * @details    In non-blocking output mode, the outputs are queued and written
+ *             as much as the console accepts, the remaining bytes are written
+ *             by the next flushes: flush again when the output file is
+ *             writable. The outputs are also flushed at the end of the
+ *             synchronized updates and before waiting for an input.
+ *
+ * @return     The number of bytes not written yet (see @c cc_outputPending)
+ *
+ * @since      0.4
+ */
+size_t cc_flushOutput();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_flushOutput, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The number of bytes not written yet
+ *
+ * @since      0.4
+ */
+size_t cc_contextFlushOutput(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the number of output bytes queued and not written yet, in
+ *             non-blocking output mode.
+ *
+ * @details    While bytes are pending, the output file must be polled for
+ *             writability and @c cc_flushOutput called when it is writable. A
+ *             growing number means the console reads slower than the outputs
+ *             are produced.
+ *
+ * @return     The number of bytes pending, always 0 in blocking mode
+ *
+ * @since      0.4
+ */
+size_t cc_outputPending();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_outputPending, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The number of bytes pending
+ *
+ * @since      0.4
+ */
+size_t cc_contextOutputPending(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the rate the console reads its outputs at, in non-blocking
+ *             output mode.
+ *
+ * @details    Measured when flushing while outputs are pending (moving
+ *             average), the time needed to write the pending outputs is
+ *             estimated with it.
+ *
+ * @return     The number of bytes written per second, 0 if not measured yet
+ *
+ * @since      0.4
+ */
+double cc_outputDrainRate();
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Same as @c cc_outputDrainRate, on the console of @p context.
+ *
+ * @param      context  The context
+ *
+ * @return     The number of bytes written per second, 0 if not measured yet
+ *
+ * @since      0.4
+ */
+double cc_contextOutputDrainRate(cc_Context* context);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Decode the first input of the given bytes read from a console,
+ *             for consoles read without the ConsoleControl input functions.
+ *
+ * @details    The keys are recognized as with @c cc_getInput, the given bytes
+ *             being the inputs waiting: an incomplete key sequence at the end
+ *             of the bytes is decoded as separate characters.
+ *
+ * @param[in]  bytes   The bytes read
+ * @param[in]  length  The number of bytes
+ * @param[out] input   The decoded input
+ *
+ * @return     The number of bytes decoded, 0 if @p length is 0
+ *
+ * @since      0.4
+ */
+size_t cc_decodeInput(const char* bytes, size_t length, cc_Input* input);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Check if bytes read from a console are the beginning of a key
+ *             sequence, which next bytes may not be read yet.
+ *
+ * @details    For consoles read without the ConsoleControl input functions,
+ *             which bytes of a key can be read separately (remote consoles):
+ *             the incomplete sequence at the end of the bytes read is kept
+ *             until the next bytes are read, or decoded with @c
+ *             cc_decodeInput after a short delay without inputs (the escape
+ *             key is the beginning of the sequences of other keys). The
+ *             incomplete sequences are shorter than 8 bytes.
+ *
+ * @param[in]  bytes   The bytes read
+ * @param[in]  length  The number of bytes
+ *
+ * @return     true if the bytes are the beginning of a longer key sequence,
+ *             false otherwise
+ *
+ * @since      0.4
+ */
+bool cc_isIncompleteInput(const char* bytes, size_t length);
+
 #endif //OS_WINDOWS
 
 #ifdef __cplusplus
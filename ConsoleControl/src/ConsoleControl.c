@@ -24,13 +24,32 @@
  *                                                                                       *
  *****************************************************************************************/
 
+// For fdopen
+#define _POSIX_C_SOURCE 200809L
+
 #include <ConsoleControl.h>
+#include <UnixConsoleControl.h>
+
+// For cc_getCurrentContext and cc_setCurrentContext, NULL for the default context
+static _Thread_local cc_Context* currentContext = NULL;
 
 #ifdef OS_WINDOWS
 
-// For cc_saveCursorPosition and cc_restoreCursorPosition
+struct cc_Context {
+	FILE* output; /* NULL for stdout, the console is shared by the whole process */
+};
+
+// For cc_getDefaultContext, the process console
+static cc_Context defaultContext = {NULL};
+
+// For cc_contextSaveCursorPosition and cc_contextRestoreCursorPosition
 static cc_Vector2 savedPosition = {0, 0};
 
+// For cc_contextEnterAlternateScreen and cc_contextLeaveAlternateScreen, content of the console window saved when entering
+static unsigned int alternateScreenDepth = 0;
+static CHAR_INFO* savedWindow = NULL;
+static CONSOLE_SCREEN_BUFFER_INFO savedWindowInfo;
+
 static WORD cc_getForegroundColorIdentifier(cc_Color color);
 
 static WORD cc_getBackgroundColorIdentifier(cc_Color color);
@@ -147,7 +166,8 @@ WORD cc_getBackgroundColorIdentifier(cc_Color color) {
 	return colorIdentifier;
 }
 
-void cc_setForegroundColor(const cc_Color color) {
+void cc_contextSetForegroundColor(cc_Context* context, const cc_Color color) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -169,7 +189,8 @@ void cc_setForegroundColor(const cc_Color color) {
 	}
 }
 
-void cc_setBackgroundColor(const cc_Color color) {
+void cc_contextSetBackgroundColor(cc_Context* context, const cc_Color color) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -191,7 +212,8 @@ void cc_setBackgroundColor(const cc_Color color) {
 	}
 }
 
-void cc_setColors(const cc_Color backgroundColor, const cc_Color foregroundColor) {
+void cc_contextSetColors(cc_Context* context, const cc_Color backgroundColor, const cc_Color foregroundColor) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -206,7 +228,8 @@ void cc_setColors(const cc_Color backgroundColor, const cc_Color foregroundColor
 	}
 }
 
-cc_type cc_getWidth() {
+cc_type cc_contextGetWidth(cc_Context* context) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -222,7 +245,8 @@ cc_type cc_getWidth() {
 	return csbi.srWindow.Right - csbi.srWindow.Left + 1;
 }
 
-cc_type cc_getHeight() {
+cc_type cc_contextGetHeight(cc_Context* context) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -238,7 +262,8 @@ cc_type cc_getHeight() {
 	return csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
 }
 
-void cc_setCursorPosition(const cc_Vector2 position) {
+void cc_contextSetCursorPosition(cc_Context* context, const cc_Vector2 position) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -262,7 +287,8 @@ void cc_setCursorPosition(const cc_Vector2 position) {
 	}
 }
 
-void cc_moveCursorUp(cc_type steps) {
+void cc_contextMoveCursorUp(cc_Context* context, cc_type steps) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -286,7 +312,8 @@ void cc_moveCursorUp(cc_type steps) {
 	}
 }
 
-void cc_moveCursorDown(cc_type steps) {
+void cc_contextMoveCursorDown(cc_Context* context, cc_type steps) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -310,7 +337,8 @@ void cc_moveCursorDown(cc_type steps) {
 	}
 }
 
-void cc_moveCursorLeft(cc_type steps) {
+void cc_contextMoveCursorLeft(cc_Context* context, cc_type steps) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -334,7 +362,8 @@ void cc_moveCursorLeft(cc_type steps) {
 	}
 }
 
-void cc_moveCursorRight(cc_type steps) {
+void cc_contextMoveCursorRight(cc_Context* context, cc_type steps) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -358,7 +387,8 @@ void cc_moveCursorRight(cc_type steps) {
 	}
 }
 
-void cc_moveCursorHorizontally(cc_type steps) {
+void cc_contextMoveCursorHorizontally(cc_Context* context, cc_type steps) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -382,7 +412,8 @@ void cc_moveCursorHorizontally(cc_type steps) {
 	}
 }
 
-void cc_moveCursorVertically(cc_type steps) {
+void cc_contextMoveCursorVertically(cc_Context* context, cc_type steps) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -406,7 +437,8 @@ void cc_moveCursorVertically(cc_type steps) {
 	}
 }
 
-void cc_moveCursor(cc_Vector2 move) {
+void cc_contextMoveCursor(cc_Context* context, cc_Vector2 move) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -430,7 +462,8 @@ void cc_moveCursor(cc_Vector2 move) {
 	}
 }
 
-void cc_saveCursorPosition() {
+void cc_contextSaveCursorPosition(cc_Context* context) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -447,7 +480,8 @@ void cc_saveCursorPosition() {
 	savedPosition.y = csbi.dwCursorPosition.Y - csbi.srWindow.Top;
 }
 
-void cc_restoreCursorPosition() {
+void cc_contextRestoreCursorPosition(cc_Context* context) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -471,7 +505,8 @@ void cc_restoreCursorPosition() {
 	}
 }
 
-void cc_setCursorVisibility(bool visibility) {
+void cc_contextSetCursorVisibility(cc_Context* context, bool visibility) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -497,7 +532,29 @@ void cc_setCursorVisibility(bool visibility) {
 	}
 }
 
-cc_Vector2 cc_clamp(const cc_Vector2 position) {
+void cc_contextSetSynchronizedOutput(cc_Context* context, bool enabled) {
+	(void) context;
+	/* Nothing to do, synchronized updates are not supported */
+	(void) enabled;
+}
+
+bool cc_contextIsSynchronizedOutputSupported(cc_Context* context) {
+	(void) context;
+	return false;
+}
+
+void cc_contextBeginSynchronizedUpdate(cc_Context* context) {
+	(void) context;
+	/* Nothing to do, synchronized updates are not supported */
+}
+
+void cc_contextEndSynchronizedUpdate(cc_Context* context) {
+	(void) context;
+	/* Nothing to do, synchronized updates are not supported */
+}
+
+cc_Vector2 cc_contextClamp(cc_Context* context, const cc_Vector2 position) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -519,7 +576,8 @@ cc_Vector2 cc_clamp(const cc_Vector2 position) {
 	return result;
 }
 
-cc_type cc_clampX(cc_type x) {
+cc_type cc_contextClampX(cc_Context* context, cc_type x) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -536,7 +594,8 @@ cc_type cc_clampX(cc_type x) {
 	return x < maxX ? (x < 0 ? 0 : x) : maxX;
 }
 
-cc_type cc_clampY(cc_type y) {
+cc_type cc_contextClampY(cc_Context* context, cc_type y) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -553,7 +612,8 @@ cc_type cc_clampY(cc_type y) {
 	return y < maxY ? (y < 0 ? 0 : y) : maxY;
 }
 
-bool cc_contains(const cc_Vector2 position) {
+bool cc_contextContains(cc_Context* context, const cc_Vector2 position) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -573,7 +633,8 @@ bool cc_contains(const cc_Vector2 position) {
 }
 
 // credits: http://www.cplusplus.com/articles/4z18T05o/
-void cc_clean() {
+void cc_contextClean(cc_Context* context) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -613,7 +674,8 @@ void cc_clean() {
 }
 
 // credits: http://www.cplusplus.com/articles/4z18T05o/
-void cc_completeClean() {
+void cc_contextCompleteClean(cc_Context* context) {
+	(void) context;
 	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
 	if(hStdOut == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -650,7 +712,144 @@ void cc_completeClean() {
 	}
 }
 
-char cc_instantGetChar() {
+void cc_contextScrollRegion(cc_Context* context, cc_type top, cc_type bottom, cc_type n) {
+	(void) context;
+	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
+	if(hStdOut == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
+		return;
+	}
+
+	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	if(!GetConsoleScreenBufferInfo(hStdOut, &csbi)) {
+		LOG_ERROR("GetConsoleScreenBufferInfo failed (error %lu)", GetLastError());
+		return;
+	}
+
+	/* Clamp the region in the console window */
+	cc_type maxY = csbi.srWindow.Bottom - csbi.srWindow.Top;
+	if(top > bottom) {
+		cc_type tmp = top;
+		top = bottom;
+		bottom = tmp;
+	}
+	top = top < maxY ? (top < 0 ? 0 : top) : maxY;
+	bottom = bottom < maxY ? (bottom < 0 ? 0 : bottom) : maxY;
+	if(n > bottom - top + 1) {
+		n = bottom - top + 1;
+	}
+	else if(n < top - bottom - 1) {
+		n = top - bottom - 1;
+	}
+	if(n == 0) {
+		return;
+	}
+
+	/* Move the region content, the exposed lines are filled with spaces */
+	SMALL_RECT region = {
+		csbi.srWindow.Left,
+		(SHORT) (csbi.srWindow.Top + top),
+		csbi.srWindow.Right,
+		(SHORT) (csbi.srWindow.Top + bottom)
+	};
+	COORD destination = {
+		region.Left,
+		(SHORT) (region.Top - n)
+	};
+	CHAR_INFO fill;
+	fill.Char.AsciiChar = ' ';
+	fill.Attributes = csbi.wAttributes;
+	if(!ScrollConsoleScreenBuffer(hStdOut, &region, &region, destination, &fill)) {
+		LOG_ERROR("ScrollConsoleScreenBuffer failed (error %lu)", GetLastError());
+	}
+}
+
+void cc_contextResetScrollRegion(cc_Context* context) {
+	(void) context;
+	/* Nothing to do, no scrolling region is kept */
+}
+
+void cc_contextEnterAlternateScreen(cc_Context* context) {
+	(void) context;
+	if(alternateScreenDepth++ != 0) {
+		return;
+	}
+
+	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
+	if(hStdOut == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
+		return;
+	}
+
+	if(!GetConsoleScreenBufferInfo(hStdOut, &savedWindowInfo)) {
+		LOG_ERROR("GetConsoleScreenBufferInfo failed (error %lu)", GetLastError());
+		return;
+	}
+
+	/* The outputs are done with printf on the console screen buffer, so no other buffer is activated:
+	 * the content of the console window is saved then cleaned */
+	COORD size = {
+		(SHORT) (savedWindowInfo.srWindow.Right - savedWindowInfo.srWindow.Left + 1),
+		(SHORT) (savedWindowInfo.srWindow.Bottom - savedWindowInfo.srWindow.Top + 1)
+	};
+	COORD origin = {0, 0};
+	savedWindow = malloc((size_t) (size.X * size.Y) * sizeof(CHAR_INFO));
+	if(savedWindow == NULL) {
+		LOG_ERROR("malloc failed");
+		return;
+	}
+	SMALL_RECT rect = savedWindowInfo.srWindow;
+	if(!ReadConsoleOutput(hStdOut, savedWindow, size, origin, &rect)) {
+		LOG_ERROR("ReadConsoleOutput failed (error %lu)", GetLastError());
+		free(savedWindow);
+		savedWindow = NULL;
+		return;
+	}
+
+	cc_clean();
+}
+
+void cc_contextLeaveAlternateScreen(cc_Context* context) {
+	(void) context;
+	if(alternateScreenDepth == 0) {
+		LOG_WARN("Not in the alternate screen");
+		return;
+	}
+	if(--alternateScreenDepth != 0 || savedWindow == NULL) {
+		return;
+	}
+
+	HANDLE hStdOut = GetStdHandle(STD_OUTPUT_HANDLE);
+	if(hStdOut == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
+		free(savedWindow);
+		savedWindow = NULL;
+		return;
+	}
+
+	fflush(stdout);
+	COORD size = {
+		(SHORT) (savedWindowInfo.srWindow.Right - savedWindowInfo.srWindow.Left + 1),
+		(SHORT) (savedWindowInfo.srWindow.Bottom - savedWindowInfo.srWindow.Top + 1)
+	};
+	COORD origin = {0, 0};
+	SMALL_RECT rect = savedWindowInfo.srWindow;
+	if(!WriteConsoleOutput(hStdOut, savedWindow, size, origin, &rect)) {
+		LOG_ERROR("WriteConsoleOutput failed (error %lu)", GetLastError());
+	}
+	if(!SetConsoleCursorPosition(hStdOut, savedWindowInfo.dwCursorPosition)) {
+		LOG_ERROR("SetConsoleCursorPosition failed (error %lu)", GetLastError());
+	}
+	if(!SetConsoleTextAttribute(hStdOut, savedWindowInfo.wAttributes)) {
+		LOG_ERROR("SetConsoleTextAttribute failed (error %lu)", GetLastError());
+	}
+
+	free(savedWindow);
+	savedWindow = NULL;
+}
+
+char cc_contextInstantGetChar(cc_Context* context) {
+	(void) context;
 	HANDLE hStdIn = GetStdHandle(STD_INPUT_HANDLE);
 	if(hStdIn == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -689,7 +888,8 @@ char cc_instantGetChar() {
 	return ch;
 }
 
-bool cc_waitingInput() {
+bool cc_contextWaitingInput(cc_Context* context) {
+	(void) context;
 	HANDLE hStdIn = GetStdHandle(STD_INPUT_HANDLE);
 	if(hStdIn == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -705,7 +905,8 @@ bool cc_waitingInput() {
 	return (num > 1);
 }
 
-void cc_displayInputs(bool display) {
+void cc_contextDisplayInputs(cc_Context* context, bool display) {
+	(void) context;
 	HANDLE hStdIn = GetStdHandle(STD_INPUT_HANDLE);
 	if(hStdIn == INVALID_HANDLE_VALUE) {
 		LOG_ERROR("GetStdHandle failed (error %lu)", GetLastError());
@@ -737,7 +938,8 @@ void cc_displayInputs(bool display) {
 
 static WORD processedInputsNb = 0;
 
-cc_Input cc_getInput() {
+cc_Input cc_contextGetInput(cc_Context* context) {
+	(void) context;
 	cc_Input input = {OTHER_KEY, 0};
 
 	HANDLE hStdIn = GetStdHandle(STD_INPUT_HANDLE);
@@ -915,6 +1117,81 @@ cc_Input cc_getInput() {
 
 #else //OS_WINDOWS
 
+// Size of the output buffer of the contexts created with cc_createContext
+#define CONTEXT_OUTPUT_BUFFER_SIZE 16384
+
+// Weight of the last measure in the output drain rate average
+#define OUTPUT_DRAIN_RATE_WEIGHT 0.25
+
+struct cc_Context {
+	int inputFd;
+	int outputFd;
+	FILE* input; /* NULL for stdin */
+	FILE* output; /* NULL for stdout */
+	struct termios savedMode; /* console mode when the context was created */
+	bool savedModeValid;
+	bool sizeCached; /* size kept until cc_contextInvalidateSize is called */
+	bool sizeFixed; /* size set by cc_contextSetSize, not queried */
+	volatile sig_atomic_t sizeOutdated;
+	unsigned short width;
+	unsigned short height;
+	cc_Color backgroundColor; /* last colors sent to the console */
+	cc_Color foregroundColor;
+	bool backgroundColorKnown;
+	bool foregroundColorKnown;
+	int synchronizedOutputSupport; /* -1 if not detected yet */
+	bool synchronizedOutputEnabled;
+	unsigned int synchronizedUpdateDepth;
+	unsigned int alternateScreenDepth;
+	cc_type scrollRegionTop; /* scrolling region set on the console (-1 for the whole screen) */
+	cc_type scrollRegionBottom;
+	unsigned short scrollRegionRows;
+	bool nonBlockingOutput;
+	int outputFlags; /* output file status flags before the non-blocking output was set */
+	FILE* blockingOutput; /* output stream replaced by the memory stream in non-blocking output mode */
+	char* memoryOutput; /* memory stream buffer */
+	size_t memoryOutputLength;
+	char* outputQueue; /* outputs not written yet, in non-blocking output mode */
+	size_t outputQueueStart;
+	size_t outputQueueLength;
+	size_t outputQueueCapacity;
+	double outputDrainRate; /* bytes written per second while outputs were pending (average), 0 if not measured */
+	struct timespec lastOutputWrite; /* time of the last write with outputs pending */
+};
+
+// Initial state of the contexts
+#define CONTEXT_INITIALIZER(inputFileDescriptor, outputFileDescriptor) { \
+	.inputFd = (inputFileDescriptor),                                    \
+	.outputFd = (outputFileDescriptor),                                  \
+	.input = NULL,                                                       \
+	.output = NULL,                                                      \
+	.savedModeValid = false,                                             \
+	.sizeCached = false,                                                 \
+	.sizeFixed = false,                                                  \
+	.sizeOutdated = 1,                                                   \
+	.backgroundColorKnown = false,                                       \
+	.foregroundColorKnown = false,                                       \
+	.synchronizedOutputSupport = -1,                                     \
+	.synchronizedOutputEnabled = false,                                  \
+	.synchronizedUpdateDepth = 0,                                        \
+	.alternateScreenDepth = 0,                                           \
+	.scrollRegionTop = -1,                                               \
+	.scrollRegionBottom = -1,                                            \
+	.scrollRegionRows = 0,                                               \
+	.nonBlockingOutput = false,                                          \
+	.blockingOutput = NULL,                                              \
+	.memoryOutput = NULL,                                                \
+	.memoryOutputLength = 0,                                             \
+	.outputQueue = NULL,                                                 \
+	.outputQueueStart = 0,                                               \
+	.outputQueueLength = 0,                                              \
+	.outputQueueCapacity = 0,                                            \
+	.outputDrainRate = 0                                                 \
+}
+
+// For cc_getDefaultContext, the process terminal (the size is not cached, resizes are not notified)
+static cc_Context defaultContext = CONTEXT_INITIALIZER(STDIN_FILENO, STDOUT_FILENO);
+
 #define _KEYS_DEF_SEC_LENGTH 5
 
 #define KEYS_DEFINITIONS_TABLE(ENTRY)         \
@@ -978,6 +1255,30 @@ static const char* cc_getForegroundColorIdentifier(cc_Color color);
 
 static const char* cc_getBackgroundColorIdentifier(cc_Color color);
 
+// For cc_contextInstantGetChar, cc_contextWaitingInput and cc_contextGetInput
+static FILE* cc_getContextInput(cc_Context* context);
+
+// For the functions using the console window size
+static bool cc_getContextSize(cc_Context* context, struct winsize* w);
+
+// For cc_contextSetSynchronizedOutput and cc_contextIsSynchronizedOutputSupported
+static bool cc_detectSynchronizedOutput(cc_Context* context);
+
+// For cc_contextInstantGetChar and cc_contextGetInput, wait for the input if the console is non-blocking
+static int cc_getContextChar(cc_Context* context);
+
+// For cc_contextFlushOutput
+static void cc_queueOutput(cc_Context* context, const char* bytes, size_t length);
+
+// For cc_contextFlushOutput and cc_contextSetNonBlockingOutput
+static void cc_writeOutputQueue(cc_Context* context);
+
+// For cc_contextFlushOutput
+static void cc_measureOutputDrainRate(cc_Context* context, size_t written);
+
+// For cc_contextSetNonBlockingOutput, registered with atexit for the default context
+static void cc_restoreBlockingOutput(void);
+
 bool cc_matchKeyDefinition(char* input, cc_Key* key) {
 	bool canMatch = false;
 	unsigned int keysDefinitionSequencesNumber = (sizeof(keysDefinitionSequences)
@@ -1000,6 +1301,174 @@ bool cc_matchKeyDefinition(char* input, cc_Key* key) {
 	return canMatch;
 }
 
+FILE* cc_getContextInput(cc_Context* context) {
+	return context->input != NULL ? context->input : stdin;
+}
+
+bool cc_getContextSize(cc_Context* context, struct winsize* w) {
+	if(context->sizeFixed || (context->sizeCached && !context->sizeOutdated)) {
+		w->ws_col = context->width;
+		w->ws_row = context->height;
+		return true;
+	}
+
+	if(ioctl(context->outputFd, TIOCGWINSZ, w) == -1) {
+		LOG_ERROR("ioctl failed");
+		return false;
+	}
+
+	if(context->sizeCached) {
+		context->sizeOutdated = 0;
+		context->width = w->ws_col;
+		context->height = w->ws_row;
+	}
+	return true;
+}
+
+int cc_getContextChar(cc_Context* context) {
+	FILE* input = cc_getContextInput(context);
+	errno = 0;
+	int ch = getc(input);
+	while(ch == EOF && errno == EAGAIN) {
+		/* Non-blocking console (non-blocking output on the same file), wait for an input */
+		clearerr(input);
+		struct pollfd pfd = {context->inputFd, POLLIN, 0};
+		poll(&pfd, 1, -1);
+		errno = 0;
+		ch = getc(input);
+	}
+	return ch;
+}
+
+void cc_queueOutput(cc_Context* context, const char* bytes, size_t length) {
+	if(context->outputQueueStart + context->outputQueueLength + length > context->outputQueueCapacity) {
+		/* Move the queued bytes at the start, then grow the queue if needed */
+		memmove(context->outputQueue,
+		        &context->outputQueue[context->outputQueueStart],
+		        context->outputQueueLength);
+		context->outputQueueStart = 0;
+		if(context->outputQueueLength + length > context->outputQueueCapacity) {
+			size_t capacity = context->outputQueueCapacity * 2;
+			if(capacity < context->outputQueueLength + length) {
+				capacity = context->outputQueueLength + length;
+			}
+			char* queue = realloc(context->outputQueue, capacity);
+			if(queue == NULL) {
+				LOG_ERROR("realloc failed, %zu output bytes dropped", length);
+				return;
+			}
+			context->outputQueue = queue;
+			context->outputQueueCapacity = capacity;
+		}
+	}
+	memcpy(&context->outputQueue[context->outputQueueStart + context->outputQueueLength], bytes, length);
+	context->outputQueueLength += length;
+}
+
+void cc_writeOutputQueue(cc_Context* context) {
+	while(context->outputQueueLength > 0) {
+		ssize_t n = write(context->outputFd,
+		                  &context->outputQueue[context->outputQueueStart],
+		                  context->outputQueueLength);
+		if(n == -1 && errno == EINTR) {
+			continue;
+		}
+		if(n == -1 && errno == EAGAIN) {
+			/* The console does not read fast enough, the remaining bytes are written later */
+			break;
+		}
+		if(n <= 0) {
+			LOG_ERROR("write failed (%s), %zu output bytes dropped", strerror(errno), context->outputQueueLength);
+			context->outputQueueLength = 0;
+			break;
+		}
+		context->outputQueueStart += (size_t) n;
+		context->outputQueueLength -= (size_t) n;
+	}
+	if(context->outputQueueLength == 0) {
+		context->outputQueueStart = 0;
+	}
+}
+
+void cc_measureOutputDrainRate(cc_Context* context, size_t written) {
+	struct timespec now;
+	if(clock_gettime(CLOCK_MONOTONIC, &now)) {
+		LOG_ERROR("clock_gettime failed (%s)", strerror(errno));
+		return;
+	}
+
+	double elapsed = (double) (now.tv_sec - context->lastOutputWrite.tv_sec)
+	                 + (double) (now.tv_nsec - context->lastOutputWrite.tv_nsec) / 1e9;
+	if(elapsed > 0) {
+		/* Exponentially weighted moving average */
+		double rate = (double) written / elapsed;
+		if(context->outputDrainRate > 0) {
+			rate = OUTPUT_DRAIN_RATE_WEIGHT * rate + (1 - OUTPUT_DRAIN_RATE_WEIGHT) * context->outputDrainRate;
+		}
+		context->outputDrainRate = rate;
+	}
+}
+
+bool cc_detectSynchronizedOutput(cc_Context* context) {
+	if(!isatty(context->inputFd) || !isatty(context->outputFd)) {
+		return false;
+	}
+
+	/* Set console mode to non canonical and no echo, to read the replies */
+	struct termios oldt, newt;
+	errno = 0;
+	if(tcgetattr(context->inputFd, &oldt)) {
+		LOG_ERROR("tcgetattr failed (%s)", strerror(errno));
+		return false;
+	}
+	newt = oldt;
+	newt.c_lflag &= ~((tcflag_t) (ICANON | ECHO));
+	newt.c_cc[VMIN] = 0;
+	newt.c_cc[VTIME] = 0;
+	errno = 0;
+	if(tcsetattr(context->inputFd, TCSANOW, &newt)) {
+		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
+		return false;
+	}
+
+	/* Query the mode state, followed by the primary attributes to not wait if the query is ignored */
+	FILE* output = cc_contextGetOutput(context);
+	fprintf(output, CSI DECRQM_SYNC_CODE CSI DA1_CODE);
+	cc_contextFlushOutput(context);
+
+	char reply[128];
+	size_t replyLength = 0;
+	struct pollfd pfd = {context->inputFd, POLLIN, 0};
+	while(replyLength < sizeof(reply) - 1 && poll(&pfd, 1, 200) > 0) {
+		ssize_t n = read(context->inputFd, &reply[replyLength], sizeof(reply) - 1 - replyLength);
+		if(n <= 0) {
+			break;
+		}
+		replyLength += (size_t) n;
+		reply[replyLength] = '\0';
+		if(reply[replyLength - 1] == 'c' && strstr(reply, CSI "?") != NULL) {
+			/* Primary attributes received, the mode state reply was received before if any */
+			break;
+		}
+	}
+	reply[replyLength] = '\0';
+
+	/* Restore console mode */
+	errno = 0;
+	if(tcsetattr(context->inputFd, TCSANOW, &oldt)) {
+		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
+	}
+
+	const char* state = strstr(reply, CSI "?2026;");
+	if(state == NULL) {
+		LOG_INFO("Synchronized output not supported");
+		return false;
+	}
+	state += strlen(CSI "?2026;");
+	LOG_INFO("Synchronized output mode state: %c", *state);
+	return (*state == '1' || *state == '2' || *state == '3') && state[1] == '$';
+}
+
 const char* cc_getForegroundColorIdentifier(cc_Color color) {
 	switch(color) {
 		case BLACK:
@@ -1078,123 +1547,344 @@ const char* cc_getBackgroundColorIdentifier(cc_Color color) {
 	}
 }
 
-void cc_setForegroundColor(cc_Color color) {
-	printf(CSI "%s" SGR_CODE, cc_getForegroundColorIdentifier(color));
+cc_Context* cc_createContext(int inputFd, int outputFd) {
+	cc_Context* context = malloc(sizeof(cc_Context));
+	if(context == NULL) {
+		LOG_ERROR("malloc failed");
+		return NULL;
+	}
+	cc_Context initialContext = CONTEXT_INITIALIZER(inputFd, outputFd);
+	*context = initialContext;
+	context->sizeCached = true;
+	context->sizeOutdated = 1;
+
+	/* The streams use duplicated file descriptors, closing them does not close the given ones */
+	errno = 0;
+	int fd = dup(inputFd);
+	if(fd == -1 || (context->input = fdopen(fd, "r")) == NULL) {
+		LOG_ERROR("input stream opening failed (%s)", strerror(errno));
+		if(fd != -1) {
+			close(fd);
+		}
+		free(context);
+		return NULL;
+	}
+	errno = 0;
+	fd = dup(outputFd);
+	if(fd == -1 || (context->output = fdopen(fd, "w")) == NULL) {
+		LOG_ERROR("output stream opening failed (%s)", strerror(errno));
+		if(fd != -1) {
+			close(fd);
+		}
+		fclose(context->input);
+		free(context);
+		return NULL;
+	}
+
+	/* Fully buffered output, sent when a synchronized update ends or before waiting an input */
+	if(setvbuf(context->output, NULL, _IOFBF, CONTEXT_OUTPUT_BUFFER_SIZE)) {
+		LOG_WARN("setvbuf failed, default output buffering used");
+	}
+
+	/* Save console mode, restored by cc_destroyContext */
+	context->savedModeValid = isatty(inputFd) && tcgetattr(inputFd, &context->savedMode) == 0;
+
+	return context;
 }
 
-void cc_setBackgroundColor(cc_Color color) {
-	printf(CSI "%s" SGR_CODE, cc_getBackgroundColorIdentifier(color));
+void cc_destroyContext(cc_Context* context) {
+	if(context == NULL || context == &defaultContext) {
+		return;
+	}
+	if(currentContext == context) {
+		currentContext = NULL;
+	}
+
+	if(context->nonBlockingOutput) {
+		/* Not waiting for a console which does not read its outputs */
+		cc_contextFlushOutput(context);
+		if(context->outputQueueLength > 0) {
+			LOG_WARN("%zu output bytes dropped", context->outputQueueLength);
+		}
+		context->outputQueueLength = 0;
+		cc_contextSetNonBlockingOutput(context, false);
+	}
+	fflush(context->output);
+	if(context->savedModeValid) {
+		errno = 0;
+		if(tcsetattr(context->inputFd, TCSANOW, &context->savedMode)) {
+			LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
+		}
+	}
+	fclose(context->input);
+	fclose(context->output);
+	free(context);
 }
 
-void cc_setColors(cc_Color backgroundColor, cc_Color foregroundColor) {
-	printf(CSI "%s" SGR_CODE, cc_getBackgroundColorIdentifier(backgroundColor));
-	printf(CSI "%s" SGR_CODE, cc_getForegroundColorIdentifier(foregroundColor));
+void cc_contextInvalidateSize(cc_Context* context) {
+	context->sizeOutdated = 1;
 }
 
-cc_type cc_getWidth() {
+void cc_contextSetSize(cc_Context* context, cc_type width, cc_type height) {
+	context->sizeFixed = width > 0 && height > 0;
+	context->width = context->sizeFixed ? (unsigned short) width : 0;
+	context->height = context->sizeFixed ? (unsigned short) height : 0;
+	context->sizeOutdated = 1;
+}
+
+void cc_contextSetNonBlockingOutput(cc_Context* context, bool nonBlocking) {
+	if(nonBlocking == context->nonBlockingOutput) {
+		return;
+	}
+
+	if(nonBlocking) {
+		fflush(cc_contextGetOutput(context));
+
+		/* Non-blocking writes */
+		errno = 0;
+		int flags = fcntl(context->outputFd, F_GETFL, 0);
+		if(flags == -1 || fcntl(context->outputFd, F_SETFL, flags | O_NONBLOCK) == -1) {
+			LOG_ERROR("fcntl failed (%s)", strerror(errno));
+			return;
+		}
+
+		/* The outputs are printed in memory, then queued and written when flushed */
+		errno = 0;
+		FILE* memoryOutput = open_memstream(&context->memoryOutput, &context->memoryOutputLength);
+		if(memoryOutput == NULL) {
+			LOG_ERROR("open_memstream failed (%s)", strerror(errno));
+			fcntl(context->outputFd, F_SETFL, flags);
+			return;
+		}
+		context->outputFlags = flags;
+		context->blockingOutput = context->output;
+		context->output = memoryOutput;
+		context->nonBlockingOutput = true;
+
+		/* The default context is never destroyed, its file status (shared with the shell) is restored at exit */
+		static bool restoreRegistered = false;
+		if(context == &defaultContext && !restoreRegistered) {
+			atexit(cc_restoreBlockingOutput);
+			restoreRegistered = true;
+		}
+	}
+	else {
+		/* Write all the outputs */
+		cc_contextFlushOutput(context);
+		if(fcntl(context->outputFd, F_SETFL, context->outputFlags) == -1) {
+			LOG_ERROR("fcntl failed (%s)", strerror(errno));
+		}
+		cc_writeOutputQueue(context);
+
+		fclose(context->output);
+		free(context->memoryOutput);
+		context->memoryOutput = NULL;
+		context->memoryOutputLength = 0;
+		free(context->outputQueue);
+		context->outputQueue = NULL;
+		context->outputQueueStart = 0;
+		context->outputQueueLength = 0;
+		context->outputQueueCapacity = 0;
+		context->output = context->blockingOutput;
+		context->blockingOutput = NULL;
+		context->nonBlockingOutput = false;
+	}
+}
+
+void cc_restoreBlockingOutput() {
+	cc_contextSetNonBlockingOutput(&defaultContext, false);
+}
+
+size_t cc_contextFlushOutput(cc_Context* context) {
+	FILE* output = cc_contextGetOutput(context);
+	fflush(output);
+	if(!context->nonBlockingOutput) {
+		return 0;
+	}
+
+	/* Queue the outputs printed since the last flush, then write as much as possible */
+	size_t pending = context->outputQueueLength;
+	if(context->memoryOutputLength > 0) {
+		cc_queueOutput(context, context->memoryOutput, context->memoryOutputLength);
+		fseeko(output, 0, SEEK_SET);
+	}
+	size_t queued = context->outputQueueLength;
+	cc_writeOutputQueue(context);
+
+	/* The bytes written while outputs were pending since the last flush give the rate the console reads at
+	 * (underestimated if the flushes are late, when the console is writable flush without delay) */
+	if(pending > 0) {
+		cc_measureOutputDrainRate(context, queued - context->outputQueueLength);
+	}
+	if(context->outputQueueLength > 0) {
+		clock_gettime(CLOCK_MONOTONIC, &context->lastOutputWrite);
+	}
+	return context->outputQueueLength;
+}
+
+size_t cc_contextOutputPending(cc_Context* context) {
+	return context->outputQueueLength;
+}
+
+double cc_contextOutputDrainRate(cc_Context* context) {
+	return context->outputDrainRate;
+}
+
+void cc_contextSetForegroundColor(cc_Context* context, cc_Color color) {
+	if(context->foregroundColorKnown && context->foregroundColor == color) {
+		return;
+	}
+	fprintf(cc_contextGetOutput(context), CSI "%s" SGR_CODE, cc_getForegroundColorIdentifier(color));
+	context->foregroundColor = color;
+	context->foregroundColorKnown = true;
+}
+
+void cc_contextSetBackgroundColor(cc_Context* context, cc_Color color) {
+	if(context->backgroundColorKnown && context->backgroundColor == color) {
+		return;
+	}
+	fprintf(cc_contextGetOutput(context), CSI "%s" SGR_CODE, cc_getBackgroundColorIdentifier(color));
+	context->backgroundColor = color;
+	context->backgroundColorKnown = true;
+}
+
+void cc_contextSetColors(cc_Context* context, cc_Color backgroundColor, cc_Color foregroundColor) {
+	cc_contextSetBackgroundColor(context, backgroundColor);
+	cc_contextSetForegroundColor(context, foregroundColor);
+}
+
+cc_type cc_contextGetWidth(cc_Context* context) {
 	struct winsize w;
-	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == -1) {
-		LOG_ERROR("ioctl failed");
+	if(!cc_getContextSize(context, &w)) {
 		return 0;
 	}
 
 	return w.ws_col;
 }
 
-cc_type cc_getHeight() {
+cc_type cc_contextGetHeight(cc_Context* context) {
 	struct winsize w;
-	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == -1) {
-		LOG_ERROR("ioctl failed");
+	if(!cc_getContextSize(context, &w)) {
 		return 0;
 	}
 
 	return w.ws_row;
 }
 
-void cc_setCursorPosition(cc_Vector2 position) {
-	printf(CSI "%d;%d" CUP_CODE, position.y + 1, position.x + 1);
+void cc_contextSetCursorPosition(cc_Context* context, cc_Vector2 position) {
+	fprintf(cc_contextGetOutput(context), CSI "%d;%d" CUP_CODE, position.y + 1, position.x + 1);
 }
 
-void cc_moveCursorUp(cc_type steps) {
+void cc_contextMoveCursorUp(cc_Context* context, cc_type steps) {
 	if(steps > 0) {
-		printf(CSI "%d" CUU_CODE, steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUU_CODE, steps);
 	}
 	else if(steps < 0) {
-		printf(CSI "%d" CUD_CODE, -steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUD_CODE, -steps);
 	}
 }
 
-void cc_moveCursorDown(cc_type steps) {
+void cc_contextMoveCursorDown(cc_Context* context, cc_type steps) {
 	if(steps > 0) {
-		printf(CSI "%d" CUD_CODE, steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUD_CODE, steps);
 	}
 	else if(steps < 0) {
-		printf(CSI "%d" CUU_CODE, -steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUU_CODE, -steps);
 	}
 }
 
-void cc_moveCursorLeft(cc_type steps) {
+void cc_contextMoveCursorLeft(cc_Context* context, cc_type steps) {
 	if(steps > 0) {
-		printf(CSI "%d" CUB_CODE, steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUB_CODE, steps);
 	}
 	else if(steps < 0) {
-		printf(CSI "%d" CUF_CODE, -steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUF_CODE, -steps);
 	}
 }
 
-void cc_moveCursorRight(cc_type steps) {
+void cc_contextMoveCursorRight(cc_Context* context, cc_type steps) {
 	if(steps > 0) {
-		printf(CSI "%d" CUF_CODE, steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUF_CODE, steps);
 	}
 	else if(steps < 0) {
-		printf(CSI "%d" CUB_CODE, -steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUB_CODE, -steps);
 	}
 }
 
-void cc_moveCursorHorizontally(cc_type steps) {
+void cc_contextMoveCursorHorizontally(cc_Context* context, cc_type steps) {
 	if(steps > 0) {
-		printf(CSI "%d" CUF_CODE, steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUF_CODE, steps);
 	}
 	else if(steps < 0) {
-		printf(CSI "%d" CUB_CODE, -steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUB_CODE, -steps);
 	}
 }
 
-void cc_moveCursorVertically(cc_type steps) {
+void cc_contextMoveCursorVertically(cc_Context* context, cc_type steps) {
 	if(steps > 0) {
-		printf(CSI "%d" CUD_CODE, steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUD_CODE, steps);
 	}
 	else if(steps < 0) {
-		printf(CSI "%d" CUU_CODE, -steps);
+		fprintf(cc_contextGetOutput(context), CSI "%d" CUU_CODE, -steps);
 	}
 }
 
-void cc_moveCursor(cc_Vector2 move) {
-	cc_moveCursorHorizontally(move.x);
-	cc_moveCursorVertically(move.y);
+void cc_contextMoveCursor(cc_Context* context, cc_Vector2 move) {
+	cc_contextMoveCursorHorizontally(context, move.x);
+	cc_contextMoveCursorVertically(context, move.y);
 }
 
-void cc_saveCursorPosition() {
-	printf(CSI SCP_CODE);
+void cc_contextSaveCursorPosition(cc_Context* context) {
+	fprintf(cc_contextGetOutput(context), CSI SCP_CODE);
 }
 
-void cc_restoreCursorPosition() {
-	printf(CSI RCP_CODE);
+void cc_contextRestoreCursorPosition(cc_Context* context) {
+	fprintf(cc_contextGetOutput(context), CSI RCP_CODE);
 }
 
-void cc_setCursorVisibility(bool visibility) {
+void cc_contextSetCursorVisibility(cc_Context* context, bool visibility) {
 	if(visibility) {
-		printf(CSI DECTCEM_S_CODE);
+		fprintf(cc_contextGetOutput(context), CSI DECTCEM_S_CODE);
 	}
 	else {
-		printf(CSI DECTCEM_H_CODE);
+		fprintf(cc_contextGetOutput(context), CSI DECTCEM_H_CODE);
 	}
 }
 
-cc_Vector2 cc_clamp(cc_Vector2 position) {
+void cc_contextSetSynchronizedOutput(cc_Context* context, bool enabled) {
+	context->synchronizedOutputEnabled = enabled && cc_contextIsSynchronizedOutputSupported(context);
+}
+
+bool cc_contextIsSynchronizedOutputSupported(cc_Context* context) {
+	if(context->synchronizedOutputSupport == -1) {
+		context->synchronizedOutputSupport = cc_detectSynchronizedOutput(context);
+	}
+	return context->synchronizedOutputSupport;
+}
+
+void cc_contextBeginSynchronizedUpdate(cc_Context* context) {
+	if(context->synchronizedUpdateDepth++ == 0 && context->synchronizedOutputEnabled) {
+		fprintf(cc_contextGetOutput(context), CSI SYNC_BEGIN_CODE);
+	}
+}
+
+void cc_contextEndSynchronizedUpdate(cc_Context* context) {
+	if(context->synchronizedUpdateDepth == 0) {
+		LOG_WARN("No synchronized update to end");
+		return;
+	}
+	if(--context->synchronizedUpdateDepth == 0) {
+		FILE* output = cc_contextGetOutput(context);
+		if(context->synchronizedOutputEnabled) {
+			fprintf(output, CSI SYNC_END_CODE);
+		}
+		cc_contextFlushOutput(context);
+	}
+}
+
+cc_Vector2 cc_contextClamp(cc_Context* context, cc_Vector2 position) {
 	struct winsize w;
-	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == -1) {
-		LOG_ERROR("ioctl failed");
+	if(!cc_getContextSize(context, &w)) {
 		return position;
 	}
 
@@ -1207,10 +1897,9 @@ cc_Vector2 cc_clamp(cc_Vector2 position) {
 	return result;
 }
 
-cc_type cc_clampX(cc_type x) {
+cc_type cc_contextClampX(cc_Context* context, cc_type x) {
 	struct winsize w;
-	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == -1) {
-		LOG_ERROR("ioctl failed");
+	if(!cc_getContextSize(context, &w)) {
 		return x;
 	}
 
@@ -1218,10 +1907,9 @@ cc_type cc_clampX(cc_type x) {
 	return x < maxX ? (x < 0 ? 0 : x) : maxX;
 }
 
-cc_type cc_clampY(cc_type y) {
+cc_type cc_contextClampY(cc_Context* context, cc_type y) {
 	struct winsize w;
-	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == -1) {
-		LOG_ERROR("ioctl failed");
+	if(!cc_getContextSize(context, &w)) {
 		return y;
 	}
 
@@ -1229,10 +1917,9 @@ cc_type cc_clampY(cc_type y) {
 	return y < maxY ? (y < 0 ? 0 : y) : maxY;
 }
 
-bool cc_contains(cc_Vector2 position) {
+bool cc_contextContains(cc_Context* context, cc_Vector2 position) {
 	struct winsize w;
-	if(ioctl(STDOUT_FILENO, TIOCGWINSZ, &w) == -1) {
-		LOG_ERROR("ioctl failed");
+	if(!cc_getContextSize(context, &w)) {
 		return false;
 	}
 
@@ -1242,24 +1929,112 @@ bool cc_contains(cc_Vector2 position) {
 	       && position.y < w.ws_row;
 }
 
-void cc_clean() {
-	printf(CSI "2" ED_CODE);
-	printf(CSI "0;0" CUP_CODE);
+void cc_contextClean(cc_Context* context) {
+	FILE* output = cc_contextGetOutput(context);
+	fprintf(output, CSI "2" ED_CODE);
+	fprintf(output, CSI "0;0" CUP_CODE);
 }
 
-void cc_completeClean() {
-	printf(CSI "2" ED_CODE);
-	printf(CSI "3" ED_CODE);
-	printf(CSI "0;0" CUP_CODE);
+void cc_contextCompleteClean(cc_Context* context) {
+	FILE* output = cc_contextGetOutput(context);
+	fprintf(output, CSI "2" ED_CODE);
+	fprintf(output, CSI "3" ED_CODE);
+	fprintf(output, CSI "0;0" CUP_CODE);
 }
 
-char cc_instantGetChar() {
+void cc_contextScrollRegion(cc_Context* context, cc_type top, cc_type bottom, cc_type n) {
+	struct winsize w;
+	if(!cc_getContextSize(context, &w)) {
+		return;
+	}
+
+	/* Clamp the region in the console window */
+	cc_type maxY = w.ws_row - 1;
+	if(top > bottom) {
+		cc_type tmp = top;
+		top = bottom;
+		bottom = tmp;
+	}
+	top = top < maxY ? (top < 0 ? 0 : top) : maxY;
+	bottom = bottom < maxY ? (bottom < 0 ? 0 : bottom) : maxY;
+	if(n > bottom - top + 1) {
+		n = bottom - top + 1;
+	}
+	else if(n < top - bottom - 1) {
+		n = top - bottom - 1;
+	}
+	if(n == 0) {
+		return;
+	}
+
+	/* Set the scrolling region only if not already set (the terminal reset it on resize) */
+	FILE* output = cc_contextGetOutput(context);
+	if(top != context->scrollRegionTop
+	   || bottom != context->scrollRegionBottom
+	   || w.ws_row != context->scrollRegionRows) {
+		fprintf(output, CSI SCP_CODE);
+		fprintf(output, CSI "%d;%d" DECSTBM_CODE, top + 1, bottom + 1);
+		fprintf(output, CSI RCP_CODE);
+		context->scrollRegionTop = top;
+		context->scrollRegionBottom = bottom;
+		context->scrollRegionRows = w.ws_row;
+	}
+
+	if(n > 0) {
+		fprintf(output, CSI "%d" SU_CODE, n);
+	}
+	else {
+		fprintf(output, CSI "%d" SD_CODE, -n);
+	}
+}
+
+void cc_contextResetScrollRegion(cc_Context* context) {
+	if(context->scrollRegionTop != -1) {
+		FILE* output = cc_contextGetOutput(context);
+		fprintf(output, CSI SCP_CODE);
+		fprintf(output, CSI DECSTBM_CODE);
+		fprintf(output, CSI RCP_CODE);
+		context->scrollRegionTop = -1;
+		context->scrollRegionBottom = -1;
+		context->scrollRegionRows = 0;
+	}
+}
+
+void cc_contextEnterAlternateScreen(cc_Context* context) {
+	if(context->alternateScreenDepth++ == 0) {
+		/* The scrolling region is not kept by all terminals when switching */
+		cc_contextResetScrollRegion(context);
+		fprintf(cc_contextGetOutput(context), CSI ALTBUF_ENTER_CODE);
+	}
+}
+
+void cc_contextLeaveAlternateScreen(cc_Context* context) {
+	if(context->alternateScreenDepth == 0) {
+		LOG_WARN("Not in the alternate screen");
+		return;
+	}
+	if(--context->alternateScreenDepth == 0) {
+		cc_contextResetScrollRegion(context);
+		FILE* output = cc_contextGetOutput(context);
+		fprintf(output, CSI ALTBUF_LEAVE_CODE);
+		cc_contextFlushOutput(context);
+
+		/* The colors saved when entering are restored */
+		context->backgroundColorKnown = false;
+		context->foregroundColorKnown = false;
+	}
+}
+
+char cc_contextInstantGetChar(cc_Context* context) {
 	struct termios oldt, newt;
 	char ch;
 
+	/* Send the outputs before waiting */
+	cc_contextFlushOutput(context);
+
 	/* Save console mode */
 	errno = 0;
-	if(tcgetattr(STDIN_FILENO, &oldt)) {
+	if(tcgetattr(context->inputFd, &oldt)) {
 		LOG_ERROR("tcgetattr failed (%s)", strerror(errno));
 		return 0;
 	}
@@ -1270,17 +2045,17 @@ char cc_instantGetChar() {
 	newt.c_cc[VMIN] = 1;                         // read only 1 character
 	newt.c_cc[VTIME] = 0;                        // forever wait for an input
 	errno = 0;
-	if(tcsetattr(STDIN_FILENO, TCSANOW, &newt)) {
+	if(tcsetattr(context->inputFd, TCSANOW, &newt)) {
 		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
 		return 0;
 	}
 
-	/* Wait and take first stdin char */
-	ch = (char) getchar();
+	/* Wait and take first input char */
+	ch = (char) cc_getContextChar(context);
 
 	/* Restore console mode */
 	errno = 0;
-	if(tcsetattr(STDIN_FILENO, TCSANOW, &oldt)) {
+	if(tcsetattr(context->inputFd, TCSANOW, &oldt)) {
 		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
 		return 0;
 	}
@@ -1288,14 +2063,15 @@ char cc_instantGetChar() {
 	return ch;
 }
 
-bool cc_waitingInput() {
+bool cc_contextWaitingInput(cc_Context* context) {
 	struct termios oldt, newt;
 	int ch;
 	int oldf;
+	FILE* input = cc_getContextInput(context);
 
 	/* Save console mode */
 	errno = 0;
-	if(tcgetattr(STDIN_FILENO, &oldt)) {
+	if(tcgetattr(context->inputFd, &oldt)) {
 		LOG_ERROR("tcgetattr failed (%s)", strerror(errno));
 		return false;
 	}
@@ -1304,49 +2080,49 @@ bool cc_waitingInput() {
 	newt = oldt;
 	newt.c_lflag &= ~((tcflag_t)(ICANON | ECHO));
 	errno = 0;
-	if(tcsetattr(STDIN_FILENO, TCSANOW, &newt)) {
+	if(tcsetattr(context->inputFd, TCSANOW, &newt)) {
 		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
 		return false;
 	}
 
-	/* Save stdin file status flags */
+	/* Save input file status flags */
 	errno = 0;
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
+	oldf = fcntl(context->inputFd, F_GETFL, 0);
 	if(errno) {
 		LOG_ERROR("fcntl failed (%s)", strerror(errno));
 		return false;
 	}
 
-	/* Add non blocking to file status flags, to avoid waiting user input if stdin is empty */
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
+	/* Add non blocking to file status flags, to avoid waiting user input if the input is empty */
+	fcntl(context->inputFd, F_SETFL, oldf | O_NONBLOCK);
 	if(errno) {
 		LOG_ERROR("fcntl failed (%s)", strerror(errno));
 		return false;
 	}
 
-	/* Take first stdin char */
-	ch = getchar();
+	/* Take first input char */
+	ch = getc(input);
 
 	/* Restore console mode */
 	errno = 0;
-	if(tcsetattr(STDIN_FILENO, TCSANOW, &oldt)) {
+	if(tcsetattr(context->inputFd, TCSANOW, &oldt)) {
 		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
 		return false;
 	}
 
-	/* Restore stdin file status flags */
+	/* Restore input file status flags */
 	errno = 0;
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
+	fcntl(context->inputFd, F_SETFL, oldf);
 	if(errno) {
 		LOG_ERROR("fcntl failed (%s)", strerror(errno));
 		return false;
 	}
 
-	/* Check if stdin was empty */
+	/* Check if the input was empty */
 	if(ch != EOF) {
 		errno = 0;
 		/* Put back the taken char */
-		if(ungetc(ch, stdin) == EOF) {
+		if(ungetc(ch, input) == EOF) {
 			LOG_ERROR("ungetc failed (%s)", strerror(errno));
 			return false;
 		}
@@ -1356,12 +2132,12 @@ bool cc_waitingInput() {
 	return false;
 }
 
-void cc_displayInputs(bool display) {
+void cc_contextDisplayInputs(cc_Context* context, bool display) {
 	struct termios t;
 
 	/* Get console mode */
 	errno = 0;
-	if(tcgetattr(STDIN_FILENO, &t)) {
+	if(tcgetattr(context->inputFd, &t)) {
 		LOG_ERROR("tcgetattr failed (%s)", strerror(errno));
 		return;
 	}
@@ -1374,13 +2150,64 @@ void cc_displayInputs(bool display) {
 		t.c_lflag &= ~((tcflag_t) ECHO);
 	}
 	errno = 0;
-	if(tcsetattr(STDIN_FILENO, TCSANOW, &t)) {
+	if(tcsetattr(context->inputFd, TCSANOW, &t)) {
 		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
 		return;
 	}
 }
 
-cc_Input cc_getInput() {
+size_t cc_decodeInput(const char* bytes, size_t length, cc_Input* input) {
+	input->key = OTHER_KEY;
+	input->ch = 0;
+	if(length == 0) {
+		return 0;
+	}
+
+	/* Same matching as cc_contextGetInput, the given bytes being the waiting inputs */
+	char inputChar[_KEYS_DEF_SEC_LENGTH + 1] = {0};
+	size_t chNumber = 0;
+	cc_Key matchedKey = OTHER_KEY;
+	size_t matchpos = 1; // at least just a char
+	inputChar[chNumber++] = bytes[0];
+	while(cc_matchKeyDefinition(inputChar, &matchedKey)
+	      && chNumber < length
+	      && chNumber < _KEYS_DEF_SEC_LENGTH) {
+		if(matchedKey != OTHER_KEY) {
+			input->key = matchedKey;
+			matchpos = chNumber;
+			matchedKey = OTHER_KEY;
+		}
+		inputChar[chNumber] = bytes[chNumber];
+		++chNumber;
+	}
+	if(matchedKey != OTHER_KEY) {
+		input->key = matchedKey;
+		matchpos = chNumber;
+	}
+
+	if(input->key == OTHER_KEY) {
+		input->ch = bytes[0];
+	}
+	else {
+		input->ch = cc_getAssociatedChar(input->key);
+	}
+	return matchpos;
+}
+
+bool cc_isIncompleteInput(const char* bytes, size_t length) {
+	if(length == 0 || length >= _KEYS_DEF_SEC_LENGTH) {
+		return false;
+	}
+	for(size_t i = 0; i < sizeof(keysDefinitionSequences) / _KEYS_DEF_SEC_LENGTH; ++i) {
+		if(strnlen(keysDefinitionSequences[i], _KEYS_DEF_SEC_LENGTH) > length
+		   && memcmp(keysDefinitionSequences[i], bytes, length) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+cc_Input cc_contextGetInput(cc_Context* context) {
 	cc_Input input = {OTHER_KEY, 0};
 
 	struct termios oldt, newt;
@@ -1389,10 +2216,14 @@ cc_Input cc_getInput() {
 	unsigned char chNumber = 0;
 	cc_Key matchedKey = OTHER_KEY;
 	unsigned int matchpos = 1; // at least just a char
+	FILE* inputStream = cc_getContextInput(context);
+
+	/* Send the outputs before waiting */
+	cc_contextFlushOutput(context);
 
 	/* Save console mode */
 	errno = 0;
-	if(tcgetattr(STDIN_FILENO, &oldt)) {
+	if(tcgetattr(context->inputFd, &oldt)) {
 		LOG_ERROR("tcgetattr failed (%s)", strerror(errno));
 		free(inputChar);
 		return input;
@@ -1404,22 +2235,22 @@ cc_Input cc_getInput() {
 	newt.c_cc[VMIN] = 1;                         // read only 1 character
 	newt.c_cc[VTIME] = 0;                        // forever wait for an input
 	errno = 0;
-	if(tcsetattr(STDIN_FILENO, TCSANOW, &newt)) {
+	if(tcsetattr(context->inputFd, TCSANOW, &newt)) {
 		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
 		free(inputChar);
 		return input;
 	}
 
 	/* Determine the input */
-	lastch = (char) getchar();
+	lastch = (char) cc_getContextChar(context);
 	inputChar[chNumber++] = lastch;
-	while(cc_matchKeyDefinition(inputChar, &matchedKey) && cc_waitingInput()) {
+	while(cc_matchKeyDefinition(inputChar, &matchedKey) && cc_contextWaitingInput(context)) {
 		if(matchedKey != OTHER_KEY) {
 			input.key = matchedKey;
 			matchpos = chNumber;
 			matchedKey = OTHER_KEY;
 		}
-		lastch = (char) getchar();
+		lastch = (char) getc(inputStream);
 		inputChar[chNumber++] = lastch;
 	}
 	if(matchedKey != OTHER_KEY) {
@@ -1429,7 +2260,7 @@ cc_Input cc_getInput() {
 
 	/* Put back the non matched chars */
 	while(chNumber > matchpos) {
-		if(ungetc(inputChar[--chNumber], stdin) == EOF) {
+		if(ungetc(inputChar[--chNumber], inputStream) == EOF) {
 			LOG_ERROR("ungetc failed (%s)", strerror(errno));
 			free(inputChar);
 			return input;
@@ -1446,7 +2277,7 @@ cc_Input cc_getInput() {
 
 	/* Restore console mode */
 	errno = 0;
-	if(tcsetattr(STDIN_FILENO, TCSANOW, &oldt)) {
+	if(tcsetattr(context->inputFd, TCSANOW, &oldt)) {
 		LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
 		free(inputChar);
 		return input;
@@ -1458,8 +2289,168 @@ cc_Input cc_getInput() {
 
 #endif //OS_WINDOWS
 
-void cc_printInPlace(const char c) {
-	printf("%c\b", c);
+cc_Context* cc_getDefaultContext() {
+	return &defaultContext;
+}
+
+cc_Context* cc_getCurrentContext() {
+	return currentContext != NULL ? currentContext : &defaultContext;
+}
+
+void cc_setCurrentContext(cc_Context* context) {
+	currentContext = context;
+}
+
+FILE* cc_contextGetOutput(cc_Context* context) {
+	return context->output != NULL ? context->output : stdout;
+}
+
+FILE* cc_getOutput() {
+	return cc_contextGetOutput(cc_getCurrentContext());
+}
+
+void cc_setForegroundColor(cc_Color color) {
+	cc_contextSetForegroundColor(cc_getCurrentContext(), color);
+}
+
+void cc_setBackgroundColor(cc_Color color) {
+	cc_contextSetBackgroundColor(cc_getCurrentContext(), color);
+}
+
+void cc_setColors(cc_Color backgroundColor, cc_Color foregroundColor) {
+	cc_contextSetColors(cc_getCurrentContext(), backgroundColor, foregroundColor);
+}
+
+cc_type cc_getWidth() {
+	return cc_contextGetWidth(cc_getCurrentContext());
+}
+
+cc_type cc_getHeight() {
+	return cc_contextGetHeight(cc_getCurrentContext());
+}
+
+void cc_setCursorPosition(cc_Vector2 position) {
+	cc_contextSetCursorPosition(cc_getCurrentContext(), position);
+}
+
+void cc_moveCursorUp(cc_type steps) {
+	cc_contextMoveCursorUp(cc_getCurrentContext(), steps);
+}
+
+void cc_moveCursorDown(cc_type steps) {
+	cc_contextMoveCursorDown(cc_getCurrentContext(), steps);
+}
+
+void cc_moveCursorLeft(cc_type steps) {
+	cc_contextMoveCursorLeft(cc_getCurrentContext(), steps);
+}
+
+void cc_moveCursorRight(cc_type steps) {
+	cc_contextMoveCursorRight(cc_getCurrentContext(), steps);
+}
+
+void cc_moveCursorHorizontally(cc_type steps) {
+	cc_contextMoveCursorHorizontally(cc_getCurrentContext(), steps);
+}
+
+void cc_moveCursorVertically(cc_type steps) {
+	cc_contextMoveCursorVertically(cc_getCurrentContext(), steps);
+}
+
+void cc_moveCursor(cc_Vector2 move) {
+	cc_contextMoveCursor(cc_getCurrentContext(), move);
+}
+
+void cc_saveCursorPosition() {
+	cc_contextSaveCursorPosition(cc_getCurrentContext());
+}
+
+void cc_restoreCursorPosition() {
+	cc_contextRestoreCursorPosition(cc_getCurrentContext());
+}
+
+void cc_setCursorVisibility(bool visibility) {
+	cc_contextSetCursorVisibility(cc_getCurrentContext(), visibility);
+}
+
+void cc_setSynchronizedOutput(bool enabled) {
+	cc_contextSetSynchronizedOutput(cc_getCurrentContext(), enabled);
+}
+
+bool cc_isSynchronizedOutputSupported() {
+	return cc_contextIsSynchronizedOutputSupported(cc_getCurrentContext());
+}
+
+void cc_beginSynchronizedUpdate() {
+	cc_contextBeginSynchronizedUpdate(cc_getCurrentContext());
+}
+
+void cc_endSynchronizedUpdate() {
+	cc_contextEndSynchronizedUpdate(cc_getCurrentContext());
+}
+
+cc_Vector2 cc_clamp(cc_Vector2 position) {
+	return cc_contextClamp(cc_getCurrentContext(), position);
+}
+
+cc_type cc_clampX(cc_type x) {
+	return cc_contextClampX(cc_getCurrentContext(), x);
+}
+
+cc_type cc_clampY(cc_type y) {
+	return cc_contextClampY(cc_getCurrentContext(), y);
+}
+
+bool cc_contains(cc_Vector2 position) {
+	return cc_contextContains(cc_getCurrentContext(), position);
+}
+
+void cc_clean() {
+	cc_contextClean(cc_getCurrentContext());
+}
+
+void cc_completeClean() {
+	cc_contextCompleteClean(cc_getCurrentContext());
+}
+
+void cc_scrollRegion(cc_type top, cc_type bottom, cc_type n) {
+	cc_contextScrollRegion(cc_getCurrentContext(), top, bottom, n);
+}
+
+void cc_resetScrollRegion() {
+	cc_contextResetScrollRegion(cc_getCurrentContext());
+}
+
+void cc_enterAlternateScreen() {
+	cc_contextEnterAlternateScreen(cc_getCurrentContext());
+}
+
+void cc_leaveAlternateScreen() {
+	cc_contextLeaveAlternateScreen(cc_getCurrentContext());
+}
+
+char cc_instantGetChar() {
+	return cc_contextInstantGetChar(cc_getCurrentContext());
+}
+
+bool cc_waitingInput() {
+	return cc_contextWaitingInput(cc_getCurrentContext());
+}
+
+void cc_displayInputs(bool display) {
+	cc_contextDisplayInputs(cc_getCurrentContext(), display);
+}
+
+cc_Input cc_getInput() {
+	return cc_contextGetInput(cc_getCurrentContext());
+}
+
+void cc_contextPrintInPlace(cc_Context* context, const char c) {
+	fprintf(cc_contextGetOutput(context), "%c\b", c);
+}
+
+void cc_printInPlace(char c) {
+	cc_contextPrintInPlace(cc_getCurrentContext(), c);
 }
 
 char cc_getAssociatedChar(cc_Key key) {
@@ -0,0 +1,230 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+#include <ConsoleControlLogPane.h>
+
+#ifndef OS_WINDOWS
+
+#include <pthread.h>
+
+struct cc_LogPane {
+	cc_Layer* layer;
+	cc_type width;
+	cc_type height;
+	lg_LogSink sink;
+	pthread_mutex_t mutex; /* protects the records, locked by the logging threads */
+	uint32_t* records; /* ring of recordsNumber logs of width codepoints */
+	cc_type* recordsLengths;
+	cc_Color* recordsColors;
+	unsigned int recordsNumber;
+	unsigned long long received; /* number of logs received, the last recordsNumber are kept */
+	uint32_t* lines; /* logs copied from the records to draw the layer without the lock, height lines of width
+	                  * codepoints */
+	cc_type* linesLengths;
+	cc_Color* linesColors;
+	unsigned int offset;
+	unsigned long long drawnBottom; /* number of logs up to the one displayed at the bottom of the layer */
+	bool drawn; /* layer drawn since the creation or the scrolling */
+};
+
+// For cc_createLogPane, log sink function
+static void writeRecords(const char* records, size_t size, void* data);
+
+// For writeRecords, color of a log depending on its level
+static cc_Color getLevelColor(const char* line, size_t length);
+
+void writeRecords(const char* records, size_t size, void* data) {
+	cc_LogPane* pane = data;
+	const char* end = records + size;
+
+	pthread_mutex_lock(&pane->mutex);
+	while(records < end) {
+		const char* lineEnd = memchr(records, '\n', (size_t) (end - records));
+		if(lineEnd == NULL) {
+			lineEnd = end;
+		}
+
+		size_t slot = (size_t) (pane->received % pane->recordsNumber);
+		uint32_t* record = &pane->records[slot * (size_t) pane->width];
+		cc_type length = 0;
+		for(const char* c = records; c < lineEnd && length < pane->width; ++length) {
+			/* One cell per character, the control characters (tabulations...) are replaced */
+			uint32_t codepoint;
+			c += cc_decodeCodepoint(c, (size_t) (lineEnd - c), &codepoint);
+			record[length] = codepoint < ' ' ? ' ' : codepoint;
+		}
+		pane->recordsLengths[slot] = length;
+		pane->recordsColors[slot] = getLevelColor(records, (size_t) (lineEnd - records));
+		++pane->received;
+
+		records = lineEnd + 1;
+	}
+	pthread_mutex_unlock(&pane->mutex);
+}
+
+cc_Color getLevelColor(const char* line, size_t length) {
+	/* Level printed between brackets by the log printers, before the message */
+	const char* level = memchr(line, '[', length);
+	if(level != NULL) {
+		size_t remaining = length - (size_t) (level - line) - 1;
+		++level;
+		if(remaining >= 4 && memcmp(level, "WARN", 4) == 0) {
+			return YELLOW;
+		}
+		if(remaining >= 5 && (memcmp(level, "ERROR", 5) == 0 || memcmp(level, "FATAL", 5) == 0)) {
+			return LIGHT_RED;
+		}
+	}
+	return WHITE;
+}
+
+cc_LogPane* cc_createLogPane(cc_Layer* layer, unsigned int recordsNumber) {
+	cc_type width = cc_getLayerWidth(layer);
+	cc_type height = cc_getLayerHeight(layer);
+	if(width <= 0 || height <= 0 || recordsNumber == 0) {
+		LOG_ERROR("Invalid log pane size");
+		return NULL;
+	}
+
+	cc_LogPane* pane = malloc(sizeof(cc_LogPane));
+	if(pane == NULL) {
+		LOG_ERROR("malloc failed");
+		return NULL;
+	}
+	int error = pthread_mutex_init(&pane->mutex, NULL);
+	if(error) {
+		LOG_ERROR("pthread_mutex_init failed (%s)", strerror(error));
+		free(pane);
+		return NULL;
+	}
+
+	pane->layer = layer;
+	pane->width = width;
+	pane->height = height;
+	pane->sink.write = writeRecords;
+	pane->sink.data = pane;
+	pane->records = malloc(recordsNumber * (size_t) width * sizeof(uint32_t));
+	pane->recordsLengths = malloc(recordsNumber * sizeof(cc_type));
+	pane->recordsColors = malloc(recordsNumber * sizeof(cc_Color));
+	pane->recordsNumber = recordsNumber;
+	pane->received = 0;
+	pane->lines = malloc((size_t) height * (size_t) width * sizeof(uint32_t));
+	pane->linesLengths = malloc((size_t) height * sizeof(cc_type));
+	pane->linesColors = malloc((size_t) height * sizeof(cc_Color));
+	pane->offset = 0;
+	pane->drawnBottom = 0;
+	pane->drawn = false;
+	if(pane->records == NULL || pane->recordsLengths == NULL || pane->recordsColors == NULL || pane->lines == NULL
+	   || pane->linesLengths == NULL || pane->linesColors == NULL) {
+		LOG_ERROR("malloc failed");
+		cc_destroyLogPane(pane);
+		return NULL;
+	}
+	return pane;
+}
+
+void cc_destroyLogPane(cc_LogPane* pane) {
+	if(pane == NULL) {
+		return;
+	}
+
+	pthread_mutex_destroy(&pane->mutex);
+	free(pane->records);
+	free(pane->recordsLengths);
+	free(pane->recordsColors);
+	free(pane->lines);
+	free(pane->linesLengths);
+	free(pane->linesColors);
+	free(pane);
+}
+
+const lg_LogSink* cc_logPaneGetSink(const cc_LogPane* pane) {
+	return &pane->sink;
+}
+
+void cc_logPaneSetScroll(cc_LogPane* pane, unsigned int offset) {
+	if(pane->offset != offset) {
+		pane->offset = offset;
+		pane->drawn = false;
+	}
+}
+
+bool cc_logPaneUpdate(cc_LogPane* pane) {
+	cc_type width = pane->width;
+	cc_type height = pane->height;
+
+	/* Copy of the logs of the lines to draw, the layer is modified without the lock */
+	pthread_mutex_lock(&pane->mutex);
+	unsigned long long received = pane->received;
+	unsigned long long bottom = received > pane->offset ? received - pane->offset : 0;
+	if(pane->drawn && bottom == pane->drawnBottom) {
+		pthread_mutex_unlock(&pane->mutex);
+		return false;
+	}
+	cc_type newLines = height;
+	if(pane->drawn && bottom > pane->drawnBottom && bottom - pane->drawnBottom < (unsigned long long) height) {
+		newLines = (cc_type) (bottom - pane->drawnBottom);
+	}
+	unsigned long long first = received > pane->recordsNumber ? received - pane->recordsNumber : 0;
+	for(cc_type line = height - newLines; line < height; ++line) {
+		unsigned long long back = (unsigned long long) (height - line);
+		pane->linesLengths[line] = 0;
+		pane->linesColors[line] = WHITE;
+		if(bottom >= back && bottom - back >= first) {
+			size_t slot = (size_t) ((bottom - back) % pane->recordsNumber);
+			memcpy(&pane->lines[(size_t) line * (size_t) width], &pane->records[slot * (size_t) width],
+			       (size_t) pane->recordsLengths[slot] * sizeof(uint32_t));
+			pane->linesLengths[line] = pane->recordsLengths[slot];
+			pane->linesColors[line] = pane->recordsColors[slot];
+		}
+	}
+	pthread_mutex_unlock(&pane->mutex);
+
+	/* The displayed lines are moved up by the number of new lines */
+	cc_Vector2 position;
+	for(position.y = 0; position.y < height - newLines; ++position.y) {
+		for(position.x = 0; position.x < width; ++position.x) {
+			cc_Vector2 from = {position.x, position.y + newLines};
+			cc_layerSetPackedCell(pane->layer, position, cc_layerGetPackedCell(pane->layer, from));
+		}
+	}
+
+	for(position.y = height - newLines; position.y < height; ++position.y) {
+		const uint32_t* text = &pane->lines[(size_t) position.y * (size_t) width];
+		cc_type length = pane->linesLengths[position.y];
+		cc_Color color = pane->linesColors[position.y];
+		for(position.x = 0; position.x < width; ++position.x) {
+			uint32_t codepoint = position.x < length ? text[position.x] : ' ';
+			cc_layerSetPackedCell(pane->layer, position, cc_packCell(codepoint, BLACK, color, NO_ATTRIBUTE));
+		}
+	}
+
+	pane->drawnBottom = bottom;
+	pane->drawn = true;
+	return true;
+}
+
+#endif //OS_WINDOWS
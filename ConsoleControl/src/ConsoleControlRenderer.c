@@ -0,0 +1,481 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+#include <ConsoleControlRenderer.h>
+#include <UnixConsoleControl.h>
+
+#ifndef OS_WINDOWS
+
+#include <pthread.h>
+#include <stdatomic.h>
+
+// Time between two tries to present a skipped frame, in milliseconds
+#define PRESENT_RETRY_DELAY 10
+
+// Initial capacities of the command buffers
+#define COMMAND_BUFFER_COMMANDS_CAPACITY 64
+#define COMMAND_BUFFER_TEXTS_CAPACITY 1024
+
+/* Intrusive multiple producers single consumer queue (Dmitry Vyukov): the producers exchange the head and link
+ * the previous head to their node, the render thread pops from the tail. A stub node keeps the queue non-empty. */
+typedef struct Node {
+	_Atomic(struct Node*) next;
+	cc_Command command; /* its text copied after the node */
+	size_t commandsNumber; /* commands of a command buffer copied after the node (then their texts), the
+	                        * command is the end of the frame */
+	cc_Vector2 topLeft; /* region of the command buffer */
+	cc_Vector2 downRight;
+} Node;
+
+struct cc_Renderer {
+	cc_Context* context;
+	cc_Screen* screen;
+	pthread_t thread;
+	_Atomic(Node*) head; /* last node pushed, exchanged by the producers */
+	Node* tail; /* next node popped, used by the render thread only */
+	Node stub;
+	atomic_bool sleeping; /* render thread waiting for commands, the first producer wakes it */
+	atomic_bool stopping;
+	int wakeFds[2]; /* pipe written to wake the render thread */
+};
+
+/* Commands recorded by a thread between cc_beginFrame and cc_endFrame, copied in one node at the end of the
+ * frame: the threads only contend on the queue head once per frame */
+typedef struct {
+	cc_Renderer* renderer; /* NULL if not recording */
+	cc_Vector2 topLeft;
+	cc_Vector2 downRight;
+	cc_Command* commands;
+	size_t* textOffsets; /* offsets of the commands texts in texts */
+	size_t commandsNumber;
+	size_t commandsCapacity;
+	char* texts;
+	size_t textsLength;
+	size_t textsCapacity;
+} CommandBuffer;
+
+// For cc_beginFrame, cc_record and cc_endFrame
+static _Thread_local CommandBuffer commandBuffer = {
+	.renderer = NULL,
+	.commands = NULL,
+	.textOffsets = NULL,
+	.commandsNumber = 0,
+	.commandsCapacity = 0,
+	.texts = NULL,
+	.textsLength = 0,
+	.textsCapacity = 0
+};
+
+// For cc_beginFrame, frees the command buffer of a thread when it exits
+static pthread_key_t commandBufferKey;
+static pthread_once_t commandBufferKeyOnce = PTHREAD_ONCE_INIT;
+
+// For cc_submit and cc_endFrame
+static void push(cc_Renderer* renderer, Node* node);
+
+// For cc_submit and cc_endFrame, wake the render thread if it waits
+static void wake(cc_Renderer* renderer);
+
+// For render
+static Node* pop(cc_Renderer* renderer);
+
+// For render, wait for commands (or the timeout in milliseconds, -1 for none)
+static void waitCommands(cc_Renderer* renderer, int timeout);
+
+// For render, apply a command clipped to a region of the screen
+static void applyCommand(cc_Screen* screen, const cc_Command* command, cc_Vector2 topLeft, cc_Vector2 downRight);
+
+// For cc_beginFrame
+static void createCommandBufferKey(void);
+
+// For createCommandBufferKey
+static void destroyCommandBuffer(void* buffer);
+
+// For cc_createRenderer, the render thread
+static void* render(void* data);
+
+void push(cc_Renderer* renderer, Node* node) {
+	atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+	Node* previous = atomic_exchange(&renderer->head, node);
+	atomic_store_explicit(&previous->next, node, memory_order_release);
+}
+
+void wake(cc_Renderer* renderer) {
+	/* Only the first producer seeing the render thread waiting writes (the head exchange is ordered before) */
+	if(atomic_load(&renderer->sleeping) && atomic_exchange(&renderer->sleeping, false)) {
+		if(write(renderer->wakeFds[1], "", 1) == -1 && errno != EAGAIN) {
+			LOG_ERROR("write failed (%s)", strerror(errno));
+		}
+	}
+}
+
+Node* pop(cc_Renderer* renderer) {
+	Node* tail = renderer->tail;
+	Node* next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	if(tail == &renderer->stub) {
+		if(next == NULL) {
+			return NULL;
+		}
+		renderer->tail = next;
+		tail = next;
+		next = atomic_load_explicit(&next->next, memory_order_acquire);
+	}
+	if(next != NULL) {
+		renderer->tail = next;
+		return tail;
+	}
+
+	/* Last node: a producer is linking a new node, or the stub is pushed again to pop it */
+	if(tail != atomic_load_explicit(&renderer->head, memory_order_acquire)) {
+		return NULL;
+	}
+	push(renderer, &renderer->stub);
+	next = atomic_load_explicit(&tail->next, memory_order_acquire);
+	if(next != NULL) {
+		renderer->tail = next;
+		return tail;
+	}
+	return NULL;
+}
+
+void waitCommands(cc_Renderer* renderer, int timeout) {
+	/* The producers see the flag set or the render thread sees their commands */
+	atomic_store(&renderer->sleeping, true);
+	if(atomic_load(&renderer->head) != renderer->tail || atomic_load(&renderer->stopping)) {
+		atomic_store(&renderer->sleeping, false);
+		return;
+	}
+
+	struct pollfd pollFd = {.fd = renderer->wakeFds[0], .events = POLLIN, .revents = 0};
+	if(poll(&pollFd, 1, timeout) == -1 && errno != EINTR) {
+		LOG_ERROR("poll failed (%s)", strerror(errno));
+	}
+	atomic_store(&renderer->sleeping, false);
+	char buffer[16];
+	while(read(renderer->wakeFds[0], buffer, sizeof(buffer)) > 0) {
+		continue;
+	}
+}
+
+void applyCommand(cc_Screen* screen, const cc_Command* command, cc_Vector2 topLeft, cc_Vector2 downRight) {
+	switch(command->type) {
+		case SET_CELL_COMMAND:
+			if(command->position.x >= topLeft.x && command->position.x <= downRight.x
+			   && command->position.y >= topLeft.y && command->position.y <= downRight.y) {
+				cc_screenSetPackedCell(screen, command->position, command->cell);
+			}
+			break;
+		case FILL_COMMAND: {
+			cc_type startX = command->position.x > topLeft.x ? command->position.x : topLeft.x;
+			cc_type endX = command->end.x < downRight.x ? command->end.x : downRight.x;
+			cc_type startY = command->position.y > topLeft.y ? command->position.y : topLeft.y;
+			cc_type endY = command->end.y < downRight.y ? command->end.y : downRight.y;
+			cc_Vector2 position;
+			for(position.y = startY; position.y <= endY; ++position.y) {
+				for(position.x = startX; position.x <= endX; ++position.x) {
+					cc_screenSetPackedCell(screen, position, command->cell);
+				}
+			}
+			break;
+		}
+		case TEXT_COMMAND: {
+			if(command->position.y < topLeft.y || command->position.y > downRight.y) {
+				break;
+			}
+			cc_Vector2 position = command->position;
+			cc_PackedCell style = command->cell & ~(cc_PackedCell) 0x1FFFFFu;
+			for(const char* c = command->text; *c != '\0' && position.x <= downRight.x; ++c) {
+				if(position.x >= topLeft.x) {
+					cc_screenSetPackedCell(screen, position, style | (unsigned char) *c);
+				}
+				++position.x;
+			}
+			break;
+		}
+		case CALL_COMMAND:
+			command->function(screen, command->data);
+			break;
+		case FRAME_COMMAND:
+			break;
+		default:
+			LOG_ERROR("Invalid command type (%d)", command->type);
+			break;
+	}
+}
+
+void* render(void* data) {
+	cc_Renderer* renderer = data;
+	cc_setCurrentContext(renderer->context);
+
+	cc_Vector2 screenTopLeft = {0, 0};
+	cc_Vector2 screenDownRight = {cc_getScreenWidth(renderer->screen) - 1, cc_getScreenHeight(renderer->screen) - 1};
+	bool late = false; /* a frame was skipped, the screen state is not presented */
+	while(true) {
+		/* Apply all the waiting commands, the frames ended meanwhile are presented once */
+		bool frameEnded = false;
+		Node* node;
+		while((node = pop(renderer)) != NULL) {
+			if(node->commandsNumber > 0) {
+				cc_Vector2 topLeft = {
+					node->topLeft.x > 0 ? node->topLeft.x : 0,
+					node->topLeft.y > 0 ? node->topLeft.y : 0
+				};
+				cc_Vector2 downRight = {
+					node->downRight.x < screenDownRight.x ? node->downRight.x : screenDownRight.x,
+					node->downRight.y < screenDownRight.y ? node->downRight.y : screenDownRight.y
+				};
+				const cc_Command* commands = (const cc_Command*) (node + 1);
+				for(size_t i = 0; i < node->commandsNumber; ++i) {
+					applyCommand(renderer->screen, &commands[i], topLeft, downRight);
+				}
+			}
+			applyCommand(renderer->screen, &node->command, screenTopLeft, screenDownRight);
+			if(node->command.type == FRAME_COMMAND) {
+				frameEnded = true;
+			}
+			free(node);
+		}
+		if(frameEnded) {
+			late = !cc_screenPresent(renderer->screen);
+		}
+
+		if(atomic_load(&renderer->stopping) && atomic_load(&renderer->head) == renderer->tail) {
+			break;
+		}
+		else if(late) {
+			late = !cc_screenPresent(renderer->screen);
+		}
+		waitCommands(renderer, late ? PRESENT_RETRY_DELAY : -1);
+	}
+
+	/* Last state, queued if the console is late */
+	cc_screenFlush(renderer->screen);
+	cc_flushOutput();
+	return NULL;
+}
+
+cc_Renderer* cc_createRenderer(cc_Context* context, cc_Screen* screen) {
+	cc_Renderer* renderer = malloc(sizeof(cc_Renderer));
+	if(renderer == NULL) {
+		LOG_ERROR("malloc failed");
+		return NULL;
+	}
+
+	renderer->context = context;
+	renderer->screen = screen;
+	atomic_init(&renderer->stub.next, NULL);
+	atomic_init(&renderer->head, &renderer->stub);
+	renderer->tail = &renderer->stub;
+	atomic_init(&renderer->sleeping, false);
+	atomic_init(&renderer->stopping, false);
+
+	if(pipe(renderer->wakeFds) == -1) {
+		LOG_ERROR("pipe failed (%s)", strerror(errno));
+		free(renderer);
+		return NULL;
+	}
+	for(int i = 0; i < 2; ++i) {
+		int flags = fcntl(renderer->wakeFds[i], F_GETFL, 0);
+		if(flags == -1 || fcntl(renderer->wakeFds[i], F_SETFL, flags | O_NONBLOCK) == -1) {
+			LOG_ERROR("fcntl failed (%s)", strerror(errno));
+		}
+	}
+
+	int error = pthread_create(&renderer->thread, NULL, render, renderer);
+	if(error) {
+		LOG_ERROR("pthread_create failed (%s)", strerror(error));
+		close(renderer->wakeFds[0]);
+		close(renderer->wakeFds[1]);
+		free(renderer);
+		return NULL;
+	}
+	return renderer;
+}
+
+void cc_destroyRenderer(cc_Renderer* renderer) {
+	if(renderer == NULL) {
+		return;
+	}
+
+	atomic_store(&renderer->stopping, true);
+	if(write(renderer->wakeFds[1], "", 1) == -1 && errno != EAGAIN) {
+		LOG_ERROR("write failed (%s)", strerror(errno));
+	}
+	int error = pthread_join(renderer->thread, NULL);
+	if(error) {
+		LOG_ERROR("pthread_join failed (%s)", strerror(error));
+	}
+	close(renderer->wakeFds[0]);
+	close(renderer->wakeFds[1]);
+	free(renderer);
+}
+
+bool cc_submit(cc_Renderer* renderer, const cc_Command* command) {
+	size_t textSize = 0;
+	if(command->type == TEXT_COMMAND) {
+		textSize = strlen(command->text) + 1;
+	}
+
+	Node* node = malloc(sizeof(Node) + textSize);
+	if(node == NULL) {
+		LOG_ERROR("malloc failed");
+		return false;
+	}
+	node->command = *command;
+	node->commandsNumber = 0;
+	if(textSize > 0) {
+		char* text = (char*) (node + 1);
+		memcpy(text, command->text, textSize);
+		node->command.text = text;
+	}
+	push(renderer, node);
+	wake(renderer);
+	return true;
+}
+
+void createCommandBufferKey() {
+	int error = pthread_key_create(&commandBufferKey, destroyCommandBuffer);
+	if(error) {
+		LOG_ERROR("pthread_key_create failed (%s)", strerror(error));
+	}
+}
+
+void destroyCommandBuffer(void* buffer) {
+	CommandBuffer* commands = buffer;
+	free(commands->commands);
+	free(commands->textOffsets);
+	free(commands->texts);
+	commands->commands = NULL;
+	commands->textOffsets = NULL;
+	commands->texts = NULL;
+	commands->commandsCapacity = 0;
+	commands->textsCapacity = 0;
+}
+
+void cc_beginFrame(cc_Renderer* renderer, cc_Vector2 topLeft, cc_Vector2 downRight) {
+	if(commandBuffer.commands == NULL) {
+		pthread_once(&commandBufferKeyOnce, createCommandBufferKey);
+		commandBuffer.commands = malloc(COMMAND_BUFFER_COMMANDS_CAPACITY * sizeof(cc_Command));
+		commandBuffer.textOffsets = malloc(COMMAND_BUFFER_COMMANDS_CAPACITY * sizeof(size_t));
+		commandBuffer.texts = malloc(COMMAND_BUFFER_TEXTS_CAPACITY);
+		if(commandBuffer.commands == NULL || commandBuffer.textOffsets == NULL || commandBuffer.texts == NULL) {
+			LOG_ERROR("malloc failed");
+			destroyCommandBuffer(&commandBuffer);
+			return;
+		}
+		commandBuffer.commandsCapacity = COMMAND_BUFFER_COMMANDS_CAPACITY;
+		commandBuffer.textsCapacity = COMMAND_BUFFER_TEXTS_CAPACITY;
+		pthread_setspecific(commandBufferKey, &commandBuffer);
+	}
+
+	commandBuffer.renderer = renderer;
+	commandBuffer.topLeft = topLeft;
+	commandBuffer.downRight = downRight;
+	commandBuffer.commandsNumber = 0;
+	commandBuffer.textsLength = 0;
+}
+
+bool cc_record(const cc_Command* command) {
+	if(commandBuffer.renderer == NULL) {
+		LOG_ERROR("No frame begun by the thread");
+		return false;
+	}
+
+	if(commandBuffer.commandsNumber == commandBuffer.commandsCapacity) {
+		size_t capacity = commandBuffer.commandsCapacity * 2;
+		cc_Command* commands = realloc(commandBuffer.commands, capacity * sizeof(cc_Command));
+		if(commands == NULL) {
+			LOG_ERROR("realloc failed");
+			return false;
+		}
+		commandBuffer.commands = commands;
+		size_t* textOffsets = realloc(commandBuffer.textOffsets, capacity * sizeof(size_t));
+		if(textOffsets == NULL) {
+			LOG_ERROR("realloc failed");
+			return false;
+		}
+		commandBuffer.textOffsets = textOffsets;
+		commandBuffer.commandsCapacity = capacity;
+	}
+
+	if(command->type == TEXT_COMMAND) {
+		size_t textSize = strlen(command->text) + 1;
+		if(commandBuffer.textsLength + textSize > commandBuffer.textsCapacity) {
+			size_t capacity = commandBuffer.textsCapacity * 2;
+			while(commandBuffer.textsLength + textSize > capacity) {
+				capacity *= 2;
+			}
+			char* texts = realloc(commandBuffer.texts, capacity);
+			if(texts == NULL) {
+				LOG_ERROR("realloc failed");
+				return false;
+			}
+			commandBuffer.texts = texts;
+			commandBuffer.textsCapacity = capacity;
+		}
+		memcpy(&commandBuffer.texts[commandBuffer.textsLength], command->text, textSize);
+		commandBuffer.textOffsets[commandBuffer.commandsNumber] = commandBuffer.textsLength;
+		commandBuffer.textsLength += textSize;
+	}
+	commandBuffer.commands[commandBuffer.commandsNumber++] = *command;
+	return true;
+}
+
+bool cc_endFrame() {
+	cc_Renderer* renderer = commandBuffer.renderer;
+	if(renderer == NULL) {
+		LOG_ERROR("No frame begun by the thread");
+		return false;
+	}
+	commandBuffer.renderer = NULL;
+
+	size_t commandsSize = commandBuffer.commandsNumber * sizeof(cc_Command);
+	Node* node = malloc(sizeof(Node) + commandsSize + commandBuffer.textsLength);
+	if(node == NULL) {
+		LOG_ERROR("malloc failed");
+		return false;
+	}
+	node->command.type = FRAME_COMMAND;
+	node->commandsNumber = commandBuffer.commandsNumber;
+	node->topLeft = commandBuffer.topLeft;
+	node->downRight = commandBuffer.downRight;
+
+	cc_Command* commands = (cc_Command*) (node + 1);
+	char* texts = (char*) (node + 1) + commandsSize;
+	memcpy(commands, commandBuffer.commands, commandsSize);
+	memcpy(texts, commandBuffer.texts, commandBuffer.textsLength);
+	for(size_t i = 0; i < commandBuffer.commandsNumber; ++i) {
+		if(commands[i].type == TEXT_COMMAND) {
+			commands[i].text = &texts[commandBuffer.textOffsets[i]];
+		}
+	}
+
+	push(renderer, node);
+	wake(renderer);
+	return true;
+}
+
+#endif //OS_WINDOWS
@@ -0,0 +1,1097 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+#include <ConsoleControlScreen.h>
+#include <UnixConsoleControl.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ROW_COMPARE_AVX2
+#define AVX2_TARGET
+#elif defined(__x86_64__) && defined(__GNUC__)
+/* AVX2 only enabled for the row comparison, used if the processor supports it */
+#include <immintrin.h>
+#define ROW_COMPARE_AVX2
+#define ROW_COMPARE_AVX2_DISPATCH
+#define ROW_COMPARE_SSE2
+#define AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ROW_COMPARE_SSE2
+#endif
+
+// Code point of the displayed cells which content is unknown
+#define UNKNOWN_CODEPOINT 0
+
+// Code point of the transparent layer cells
+#define TRANSPARENT_CODEPOINT 0
+
+// Cells
+#define DEFAULT_CELL cc_packCell(' ', BLACK, WHITE, NO_ATTRIBUTE)
+#define UNKNOWN_CELL cc_packCell(UNKNOWN_CODEPOINT, BLACK, WHITE, NO_ATTRIBUTE)
+#define TRANSPARENT_CELL cc_packCell(TRANSPARENT_CODEPOINT, BLACK, WHITE, NO_ATTRIBUTE)
+
+// Minimal number of lines of a moved block to scroll it instead of drawing it
+#define SCROLL_MIN_LINES 2
+
+// Maximal number of unchanged cells printed again to avoid moving the cursor
+#define GAP_MAX_CELLS 4
+
+// Default maximal time to write the pending outputs for a frame to be presented, in milliseconds
+#define DEFAULT_MAX_LATENCY 50
+
+typedef struct {
+	unsigned long hash;
+	unsigned int displayedCount;
+	unsigned int count;
+	cc_type displayedLine;
+	bool used;
+} HashEntry;
+
+struct cc_Layer {
+	cc_Screen* screen;
+	cc_Vector2 position;
+	cc_type width;
+	cc_type height;
+	int z;
+	bool visible;
+	cc_PackedCell* cells;
+};
+
+struct cc_Screen {
+	cc_type width;
+	cc_type height;
+	cc_PackedCell* base; /* cells drawn under the layers */
+	cc_PackedCell* cells; /* frame being drawn, base and layers composited */
+	cc_type* damageStart; /* for each line, first cell to composite again (damageStart > damageEnd if none) */
+	cc_type* damageEnd; /* for each line, last cell to composite again */
+	cc_Layer** layers; /* sorted by z-order */
+	unsigned int layersNumber;
+	cc_PackedCell* displayed; /* frame displayed by the console */
+	cc_type* dirtyStart; /* for each line, first cell which can differ between cells and displayed */
+	cc_type* dirtyEnd; /* for each line, last cell which can differ between cells and displayed */
+	unsigned long* hashes; /* hashes of the lines of the frame being drawn */
+	unsigned long* displayedHashes; /* hashes of the lines of the displayed frame */
+	bool* hashesValid; /* for each line, if the hash is up to date */
+	bool* displayedHashesValid; /* for each line, if the displayed hash is up to date */
+	cc_type* displayedLines; /* for each line, displayed line with the same content (-1 if none) */
+	HashEntry* hashTable;
+	unsigned int hashTableSize; /* power of 2 */
+	bool scrollDetection;
+	unsigned int maxLatency; /* milliseconds */
+	unsigned long skippedFrames;
+};
+
+// For cc_screenSetCell and cc_layerSetCell
+static inline cc_PackedCell packCell(cc_Cell cell);
+
+// For cc_screenGetCell and cc_layerGetCell
+static inline cc_Cell unpackCell(cc_PackedCell cell);
+
+// For drawDifferences
+static void setAttributes(FILE* output, unsigned int attributes, unsigned int previousAttributes, bool previousKnown);
+
+// For drawDifferences
+static void putCodepoint(FILE* output, uint32_t codepoint);
+
+// For drawDifferences
+static cc_type findDifference(const cc_PackedCell* line0, const cc_PackedCell* line1, cc_type from, cc_type to);
+
+#ifdef ROW_COMPARE_AVX2
+// For findDifference, first block of 8 cells with a difference
+AVX2_TARGET static cc_type skipEqualCellsAvx2(const cc_PackedCell* line0, const cc_PackedCell* line1, cc_type from,
+                                              cc_type to);
+#endif
+
+#ifdef ROW_COMPARE_SSE2
+// For findDifference, first block of 4 cells with a difference
+static cc_type skipEqualCellsSse2(const cc_PackedCell* line0, const cc_PackedCell* line1, cc_type from,
+                                  cc_type to);
+#endif
+
+// For detectScrolls
+static unsigned long hashLine(const cc_PackedCell* line, cc_type width);
+
+// For detectScrolls
+static HashEntry* findHashEntry(cc_Screen* screen, unsigned long hash);
+
+// For damage, setDirty and composite
+static void addSpans(const cc_Screen* screen, cc_type* starts, cc_type* ends, cc_type left, cc_type top,
+                     cc_type right, cc_type bottom);
+
+// For the functions modifying the base cells or the layers
+static void damage(cc_Screen* screen, cc_type left, cc_type top, cc_type right, cc_type bottom);
+
+// For the functions modifying the displayed cells
+static void setDirty(cc_Screen* screen, cc_type left, cc_type top, cc_type right, cc_type bottom);
+
+// For the functions modifying the layers
+static void damageLayer(const cc_Layer* layer);
+
+// For cc_createLayer and cc_layerSetZ
+static void sortLayers(cc_Screen* screen);
+
+// For scrollBlock
+static void scrollDisplayed(cc_Screen* screen, cc_type top, cc_type bottom, cc_type n);
+
+// For detectScrolls
+static bool scrollBlock(cc_Context* context, cc_Screen* screen, cc_type first, cc_type last, cc_type shift);
+
+// For cc_contextScreenFlush
+static void composite(cc_Screen* screen);
+
+// For cc_contextScreenFlush, true if lines were scrolled
+static bool detectScrolls(cc_Context* context, cc_Screen* screen);
+
+// For cc_contextScreenFlush
+static void drawDifferences(cc_Context* context, cc_Screen* screen);
+
+cc_PackedCell packCell(cc_Cell cell) {
+	return cc_packCell((unsigned char) cell.ch, cell.backgroundColor, cell.foregroundColor, NO_ATTRIBUTE);
+}
+
+cc_Cell unpackCell(cc_PackedCell cell) {
+	uint32_t codepoint = cc_cellCodepoint(cell);
+	cc_Cell unpacked = {
+		codepoint > 0xFF ? '?' : (char) codepoint,
+		cc_cellBackgroundColor(cell),
+		cc_cellForegroundColor(cell)
+	};
+	return unpacked;
+}
+
+void setAttributes(FILE* output, unsigned int attributes, unsigned int previousAttributes, bool previousKnown) {
+#ifndef OS_WINDOWS
+	unsigned int changed = BOLD_ATTRIBUTE | UNDERLINE_ATTRIBUTE | REVERSE_ATTRIBUTE;
+	if(previousKnown) {
+		changed = attributes ^ previousAttributes;
+	}
+
+	/* All the changes in one sequence */
+	const char* values[3];
+	unsigned int valuesNumber = 0;
+	if(changed & BOLD_ATTRIBUTE) {
+		values[valuesNumber++] = attributes & BOLD_ATTRIBUTE ? SGR_BOLD_VALUE : SGR_NORMAL_INTENSITY_VALUE;
+	}
+	if(changed & UNDERLINE_ATTRIBUTE) {
+		values[valuesNumber++] = attributes & UNDERLINE_ATTRIBUTE ? SGR_UNDERLINE_VALUE : SGR_UNDERLINE_OFF_VALUE;
+	}
+	if(changed & REVERSE_ATTRIBUTE) {
+		values[valuesNumber++] = attributes & REVERSE_ATTRIBUTE ? SGR_REVERSE_VALUE : SGR_REVERSE_OFF_VALUE;
+	}
+	if(valuesNumber) {
+		fprintf(output, CSI "%s", values[0]);
+		for(unsigned int i = 1; i < valuesNumber; ++i) {
+			fprintf(output, ";%s", values[i]);
+		}
+		fprintf(output, SGR_CODE);
+	}
+#else
+	/* Nothing to do, the attributes are not rendered */
+	(void) attributes;
+	(void) previousAttributes;
+	(void) previousKnown;
+#endif
+}
+
+void putCodepoint(FILE* output, uint32_t codepoint) {
+#ifndef OS_WINDOWS
+	/* UTF-8 */
+	if(codepoint < 0x80) {
+		putc((int) codepoint, output);
+	}
+	else if(codepoint < 0x800) {
+		putc((int) (0xC0 | codepoint >> 6), output);
+		putc((int) (0x80 | (codepoint & 0x3F)), output);
+	}
+	else if(codepoint < 0x10000) {
+		putc((int) (0xE0 | codepoint >> 12), output);
+		putc((int) (0x80 | (codepoint >> 6 & 0x3F)), output);
+		putc((int) (0x80 | (codepoint & 0x3F)), output);
+	}
+	else {
+		putc((int) (0xF0 | codepoint >> 18), output);
+		putc((int) (0x80 | (codepoint >> 12 & 0x3F)), output);
+		putc((int) (0x80 | (codepoint >> 6 & 0x3F)), output);
+		putc((int) (0x80 | (codepoint & 0x3F)), output);
+	}
+#else
+	/* Code page characters */
+	putc(codepoint > 0xFF ? '?' : (int) codepoint, output);
+#endif
+}
+
+cc_type findDifference(const cc_PackedCell* line0, const cc_PackedCell* line1, cc_type from, cc_type to) {
+	cc_type x = from;
+#if defined(ROW_COMPARE_AVX2_DISPATCH)
+	if(__builtin_cpu_supports("avx2")) {
+		x = skipEqualCellsAvx2(line0, line1, x, to);
+	}
+	else {
+		x = skipEqualCellsSse2(line0, line1, x, to);
+	}
+#elif defined(ROW_COMPARE_AVX2)
+	x = skipEqualCellsAvx2(line0, line1, x, to);
+#elif defined(ROW_COMPARE_SSE2)
+	x = skipEqualCellsSse2(line0, line1, x, to);
+#endif
+	while(x <= to && line0[x] == line1[x]) {
+		++x;
+	}
+	return x;
+}
+
+#ifdef ROW_COMPARE_AVX2
+cc_type skipEqualCellsAvx2(const cc_PackedCell* line0, const cc_PackedCell* line1, cc_type from, cc_type to) {
+	cc_type x = from;
+	for(; x + 8 <= to + 1; x += 8) {
+		__m256i cells0 = _mm256_loadu_si256((const __m256i*) &line0[x]);
+		__m256i cells1 = _mm256_loadu_si256((const __m256i*) &line1[x]);
+		if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(cells0, cells1)) != -1) {
+			break;
+		}
+	}
+	return x;
+}
+#endif
+
+#ifdef ROW_COMPARE_SSE2
+cc_type skipEqualCellsSse2(const cc_PackedCell* line0, const cc_PackedCell* line1, cc_type from, cc_type to) {
+	cc_type x = from;
+	for(; x + 4 <= to + 1; x += 4) {
+		__m128i cells0 = _mm_loadu_si128((const __m128i*) &line0[x]);
+		__m128i cells1 = _mm_loadu_si128((const __m128i*) &line1[x]);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi32(cells0, cells1)) != 0xFFFF) {
+			break;
+		}
+	}
+	return x;
+}
+#endif
+
+unsigned long hashLine(const cc_PackedCell* line, cc_type width) {
+	/* FNV-1a, on the packed cells */
+	unsigned long hash = 2166136261UL;
+	for(cc_type x = 0; x < width; ++x) {
+		hash = (hash ^ line[x]) * 16777619UL;
+	}
+	return hash;
+}
+
+HashEntry* findHashEntry(cc_Screen* screen, unsigned long hash) {
+	unsigned int i = (unsigned int) (hash & (screen->hashTableSize - 1));
+	while(screen->hashTable[i].used && screen->hashTable[i].hash != hash) {
+		i = (i + 1) & (screen->hashTableSize - 1);
+	}
+	if(!screen->hashTable[i].used) {
+		screen->hashTable[i].used = true;
+		screen->hashTable[i].hash = hash;
+		screen->hashTable[i].displayedCount = 0;
+		screen->hashTable[i].count = 0;
+		screen->hashTable[i].displayedLine = -1;
+	}
+	return &screen->hashTable[i];
+}
+
+void addSpans(const cc_Screen* screen, cc_type* starts, cc_type* ends, cc_type left, cc_type top,
+              cc_type right, cc_type bottom) {
+	if(left < 0) {
+		left = 0;
+	}
+	if(top < 0) {
+		top = 0;
+	}
+	if(right >= screen->width) {
+		right = screen->width - 1;
+	}
+	if(bottom >= screen->height) {
+		bottom = screen->height - 1;
+	}
+	if(left > right) {
+		return;
+	}
+	for(cc_type y = top; y <= bottom; ++y) {
+		if(left < starts[y]) {
+			starts[y] = left;
+		}
+		if(right > ends[y]) {
+			ends[y] = right;
+		}
+	}
+}
+
+void damage(cc_Screen* screen, cc_type left, cc_type top, cc_type right, cc_type bottom) {
+	addSpans(screen, screen->damageStart, screen->damageEnd, left, top, right, bottom);
+}
+
+void setDirty(cc_Screen* screen, cc_type left, cc_type top, cc_type right, cc_type bottom) {
+	addSpans(screen, screen->dirtyStart, screen->dirtyEnd, left, top, right, bottom);
+	for(cc_type y = top < 0 ? 0 : top; y <= bottom && y < screen->height; ++y) {
+		screen->displayedHashesValid[y] = false;
+	}
+}
+
+void damageLayer(const cc_Layer* layer) {
+	damage(layer->screen, layer->position.x, layer->position.y,
+	       layer->position.x + layer->width - 1, layer->position.y + layer->height - 1);
+}
+
+void sortLayers(cc_Screen* screen) {
+	/* Insertion sort, stable: the last created layer is above the ones with the same z-order */
+	for(unsigned int i = 1; i < screen->layersNumber; ++i) {
+		cc_Layer* layer = screen->layers[i];
+		unsigned int j = i;
+		for(; j > 0 && screen->layers[j - 1]->z > layer->z; --j) {
+			screen->layers[j] = screen->layers[j - 1];
+		}
+		screen->layers[j] = layer;
+	}
+}
+
+void scrollDisplayed(cc_Screen* screen, cc_type top, cc_type bottom, cc_type n) {
+	cc_type w = screen->width;
+	cc_type lines = n > 0 ? n : -n;
+	cc_type moved = bottom - top + 1 - lines;
+	cc_type exposed;
+	if(n > 0) {
+		memmove(&screen->displayed[top * w], &screen->displayed[(top + lines) * w],
+		        (size_t) (moved * w) * sizeof(cc_PackedCell));
+		memmove(&screen->displayedHashes[top], &screen->displayedHashes[top + lines],
+		        (size_t) moved * sizeof(unsigned long));
+		exposed = bottom - lines + 1;
+	}
+	else {
+		memmove(&screen->displayed[(top + lines) * w], &screen->displayed[top * w],
+		        (size_t) (moved * w) * sizeof(cc_PackedCell));
+		memmove(&screen->displayedHashes[top + lines], &screen->displayedHashes[top],
+		        (size_t) moved * sizeof(unsigned long));
+		exposed = top;
+	}
+
+	/* The content of the exposed lines depends on the console, it is unknown */
+	for(cc_type y = exposed; y < exposed + lines; ++y) {
+		for(cc_type x = 0; x < w; ++x) {
+			screen->displayed[y * w + x] = UNKNOWN_CELL;
+		}
+		screen->displayedHashes[y] = hashLine(&screen->displayed[y * w], w);
+	}
+
+	/* The moved lines may not be at their place yet */
+	addSpans(screen, screen->dirtyStart, screen->dirtyEnd, 0, top, w - 1, bottom);
+}
+
+bool scrollBlock(cc_Context* context, cc_Screen* screen, cc_type first, cc_type last, cc_type shift) {
+	/* Check the block is still displayed where it was found (previous scrolls may have moved it) */
+	for(cc_type y = first; y <= last; ++y) {
+		if(screen->hashes[y] != screen->displayedHashes[y + shift]) {
+			return false;
+		}
+	}
+
+	if(shift > 0) {
+		cc_contextScrollRegion(context, first, last + shift, shift);
+		scrollDisplayed(screen, first, last + shift, shift);
+	}
+	else {
+		cc_contextScrollRegion(context, first + shift, last, shift);
+		scrollDisplayed(screen, first + shift, last, shift);
+	}
+	return true;
+}
+
+void composite(cc_Screen* screen) {
+	cc_type w = screen->width;
+	for(cc_type y = 0; y < screen->height; ++y) {
+		cc_type start = screen->damageStart[y];
+		cc_type end = screen->damageEnd[y];
+		if(start > end) {
+			continue;
+		}
+		memcpy(&screen->cells[y * w + start], &screen->base[y * w + start],
+		       (size_t) (end - start + 1) * sizeof(cc_PackedCell));
+
+		/* Layers from the bottom to the top */
+		for(unsigned int i = 0; i < screen->layersNumber; ++i) {
+			const cc_Layer* layer = screen->layers[i];
+			cc_type layerY = y - layer->position.y;
+			if(!layer->visible || layerY < 0 || layerY >= layer->height) {
+				continue;
+			}
+			cc_type from = start > layer->position.x ? start : layer->position.x;
+			cc_type to = end < layer->position.x + layer->width - 1 ? end : layer->position.x + layer->width - 1;
+			const cc_PackedCell* layerLine = &layer->cells[layerY * layer->width];
+			for(cc_type x = from; x <= to; ++x) {
+				if(cc_cellCodepoint(layerLine[x - layer->position.x]) != TRANSPARENT_CODEPOINT) {
+					screen->cells[y * w + x] = layerLine[x - layer->position.x];
+				}
+			}
+		}
+
+		addSpans(screen, screen->dirtyStart, screen->dirtyEnd, start, y, end, y);
+		screen->hashesValid[y] = false;
+		screen->damageStart[y] = w;
+		screen->damageEnd[y] = -1;
+	}
+}
+
+bool detectScrolls(cc_Context* context, cc_Screen* screen) {
+	cc_type w = screen->width;
+	cc_type h = screen->height;
+	if(w != cc_contextGetWidth(context) || h > cc_contextGetHeight(context)) {
+		return false;
+	}
+
+	/* A moved block has all its lines changed */
+	cc_type dirtyLines = 0;
+	for(cc_type y = 0; y < h && dirtyLines < SCROLL_MIN_LINES; ++y) {
+		if(screen->dirtyStart[y] <= screen->dirtyEnd[y]) {
+			++dirtyLines;
+		}
+	}
+	if(dirtyLines < SCROLL_MIN_LINES) {
+		return false;
+	}
+
+	for(cc_type y = 0; y < h; ++y) {
+		if(!screen->hashesValid[y]) {
+			screen->hashes[y] = hashLine(&screen->cells[y * w], w);
+			screen->hashesValid[y] = true;
+		}
+		if(!screen->displayedHashesValid[y]) {
+			screen->displayedHashes[y] = hashLine(&screen->displayed[y * w], w);
+			screen->displayedHashesValid[y] = true;
+		}
+	}
+
+	/* Match the lines which hash is unique in both frames */
+	memset(screen->hashTable, 0, screen->hashTableSize * sizeof(HashEntry));
+	for(cc_type y = 0; y < h; ++y) {
+		HashEntry* entry = findHashEntry(screen, screen->displayedHashes[y]);
+		++entry->displayedCount;
+		entry->displayedLine = y;
+	}
+	for(cc_type y = 0; y < h; ++y) {
+		++findHashEntry(screen, screen->hashes[y])->count;
+	}
+	for(cc_type y = 0; y < h; ++y) {
+		HashEntry* entry = findHashEntry(screen, screen->hashes[y]);
+		if(entry->count == 1 && entry->displayedCount == 1) {
+			screen->displayedLines[y] = entry->displayedLine;
+		}
+		else {
+			screen->displayedLines[y] = -1;
+		}
+	}
+
+	/* Grow the matches to the neighbour lines with the same content (blank lines...) */
+	for(cc_type y = 0; y < h; ++y) {
+		if(screen->displayedLines[y] != -1) {
+			cc_type line = y + 1;
+			cc_type displayedLine = screen->displayedLines[y] + 1;
+			while(line < h && displayedLine < h && screen->displayedLines[line] == -1
+			      && screen->hashes[line] == screen->displayedHashes[displayedLine]) {
+				screen->displayedLines[line++] = displayedLine++;
+			}
+		}
+	}
+	for(cc_type y = h; y--;) {
+		if(screen->displayedLines[y] != -1) {
+			cc_type line = y - 1;
+			cc_type displayedLine = screen->displayedLines[y] - 1;
+			while(line >= 0 && displayedLine >= 0 && screen->displayedLines[line] == -1
+			      && screen->hashes[line] == screen->displayedHashes[displayedLine]) {
+				screen->displayedLines[line--] = displayedLine--;
+			}
+		}
+	}
+
+	/* Scroll the blocks moved up from top to bottom, then the blocks moved down from bottom to top */
+	bool scrolled = false;
+	for(cc_type y = 0; y < h;) {
+		if(screen->displayedLines[y] == -1) {
+			++y;
+			continue;
+		}
+		cc_type first = y;
+		cc_type shift = screen->displayedLines[y] - y;
+		++y;
+		while(y < h && screen->displayedLines[y] != -1 && screen->displayedLines[y] - y == shift) {
+			++y;
+		}
+		if(shift > 0 && y - first >= SCROLL_MIN_LINES) {
+			scrolled = scrollBlock(context, screen, first, y - 1, shift) || scrolled;
+		}
+	}
+	for(cc_type y = h - 1; y >= 0;) {
+		if(screen->displayedLines[y] == -1) {
+			--y;
+			continue;
+		}
+		cc_type last = y;
+		cc_type shift = screen->displayedLines[y] - y;
+		--y;
+		while(y >= 0 && screen->displayedLines[y] != -1 && screen->displayedLines[y] - y == shift) {
+			--y;
+		}
+		if(shift < 0 && last - y >= SCROLL_MIN_LINES) {
+			scrolled = scrollBlock(context, screen, y + 1, last, shift) || scrolled;
+		}
+	}
+	return scrolled;
+}
+
+void drawDifferences(cc_Context* context, cc_Screen* screen) {
+	FILE* output = cc_contextGetOutput(context);
+	cc_type w = screen->width;
+	cc_Vector2 cursor = {-1, -1};
+	cc_Color backgroundColor = BLACK;
+	cc_Color foregroundColor = WHITE;
+	unsigned int attributes = NO_ATTRIBUTE;
+	bool colorsKnown = false;
+
+	for(cc_type y = 0; y < screen->height; ++y) {
+		cc_type start = screen->dirtyStart[y];
+		cc_type end = screen->dirtyEnd[y];
+		if(start > end) {
+			continue;
+		}
+		screen->dirtyStart[y] = w;
+		screen->dirtyEnd[y] = -1;
+
+		const cc_PackedCell* line = &screen->cells[y * w];
+		cc_PackedCell* displayedLine = &screen->displayed[y * w];
+		for(cc_type x = findDifference(line, displayedLine, start, end); x <= end;
+		    x = findDifference(line, displayedLine, x + 1, end)) {
+			screen->displayedHashesValid[y] = false;
+			cc_Color cellBackgroundColor = cc_cellBackgroundColor(line[x]);
+			cc_Color cellForegroundColor = cc_cellForegroundColor(line[x]);
+			unsigned int cellAttributes = cc_cellAttributes(line[x]);
+
+			/* Move the cursor, or print again a few unchanged cells if cheaper */
+			if(cursor.y != y || cursor.x != x) {
+				bool printGap = colorsKnown && cursor.y == y && cursor.x >= 0 && cursor.x < x
+				                && x - cursor.x <= GAP_MAX_CELLS;
+				for(cc_type i = cursor.x; printGap && i < x; ++i) {
+					printGap = cc_cellBackgroundColor(line[i]) == backgroundColor
+					           && cc_cellForegroundColor(line[i]) == foregroundColor
+					           && cc_cellAttributes(line[i]) == attributes;
+				}
+				if(printGap) {
+					for(; cursor.x < x; ++cursor.x) {
+						putCodepoint(output, cc_cellCodepoint(line[cursor.x]));
+					}
+				}
+				else {
+					cursor.x = x;
+					cursor.y = y;
+					cc_contextSetCursorPosition(context, cursor);
+				}
+			}
+
+			/* Set the attributes and the colors */
+			if(!colorsKnown || cellAttributes != attributes) {
+				setAttributes(output, cellAttributes, attributes, colorsKnown);
+			}
+			if(!colorsKnown
+			   || (cellBackgroundColor != backgroundColor && cellForegroundColor != foregroundColor)) {
+				cc_contextSetColors(context, cellBackgroundColor, cellForegroundColor);
+			}
+			else if(cellBackgroundColor != backgroundColor) {
+				cc_contextSetBackgroundColor(context, cellBackgroundColor);
+			}
+			else if(cellForegroundColor != foregroundColor) {
+				cc_contextSetForegroundColor(context, cellForegroundColor);
+			}
+			backgroundColor = cellBackgroundColor;
+			foregroundColor = cellForegroundColor;
+			attributes = cellAttributes;
+			colorsKnown = true;
+
+			putCodepoint(output, cc_cellCodepoint(line[x]));
+			displayedLine[x] = line[x];
+			if(++cursor.x == w) {
+				/* The cursor position after the last column depends on the console */
+				cursor.x = -1;
+			}
+		}
+	}
+}
+
+cc_Screen* cc_createScreen(cc_type width, cc_type height) {
+	if(width <= 0 || height <= 0) {
+		LOG_ERROR("Invalid screen size (%dx%d)", width, height);
+		return NULL;
+	}
+
+	cc_Screen* screen = malloc(sizeof(cc_Screen));
+	if(screen == NULL) {
+		LOG_ERROR("malloc failed");
+		return NULL;
+	}
+	screen->width = width;
+	screen->height = height;
+	screen->hashTableSize = 1;
+	while(screen->hashTableSize < 2 * (unsigned int) height) {
+		screen->hashTableSize <<= 1;
+	}
+	screen->base = malloc((size_t) (width * height) * sizeof(cc_PackedCell));
+	screen->cells = malloc((size_t) (width * height) * sizeof(cc_PackedCell));
+	screen->damageStart = malloc((size_t) height * sizeof(cc_type));
+	screen->damageEnd = malloc((size_t) height * sizeof(cc_type));
+	screen->layers = NULL;
+	screen->layersNumber = 0;
+	screen->displayed = malloc((size_t) (width * height) * sizeof(cc_PackedCell));
+	screen->dirtyStart = malloc((size_t) height * sizeof(cc_type));
+	screen->dirtyEnd = malloc((size_t) height * sizeof(cc_type));
+	screen->hashes = malloc((size_t) height * sizeof(unsigned long));
+	screen->displayedHashes = malloc((size_t) height * sizeof(unsigned long));
+	screen->hashesValid = malloc((size_t) height * sizeof(bool));
+	screen->displayedHashesValid = malloc((size_t) height * sizeof(bool));
+	screen->displayedLines = malloc((size_t) height * sizeof(cc_type));
+	screen->hashTable = malloc(screen->hashTableSize * sizeof(HashEntry));
+	screen->scrollDetection = true;
+	screen->maxLatency = DEFAULT_MAX_LATENCY;
+	screen->skippedFrames = 0;
+	if(screen->base == NULL || screen->cells == NULL || screen->damageStart == NULL || screen->damageEnd == NULL
+	   || screen->displayed == NULL || screen->dirtyStart == NULL || screen->dirtyEnd == NULL
+	   || screen->hashes == NULL || screen->displayedHashes == NULL || screen->hashesValid == NULL
+	   || screen->displayedHashesValid == NULL || screen->displayedLines == NULL || screen->hashTable == NULL) {
+		LOG_ERROR("malloc failed");
+		cc_destroyScreen(screen);
+		return NULL;
+	}
+
+	for(cc_type i = width * height; i--;) {
+		screen->base[i] = DEFAULT_CELL;
+		screen->cells[i] = DEFAULT_CELL;
+	}
+	for(cc_type y = height; y--;) {
+		screen->damageStart[y] = width;
+		screen->damageEnd[y] = -1;
+		screen->dirtyStart[y] = width;
+		screen->dirtyEnd[y] = -1;
+		screen->hashesValid[y] = false;
+	}
+	cc_screenInvalidate(screen);
+
+	return screen;
+}
+
+void cc_destroyScreen(cc_Screen* screen) {
+	if(screen == NULL) {
+		return;
+	}
+	while(screen->layersNumber) {
+		cc_destroyLayer(screen->layers[screen->layersNumber - 1]);
+	}
+	free(screen->layers);
+	free(screen->base);
+	free(screen->cells);
+	free(screen->damageStart);
+	free(screen->damageEnd);
+	free(screen->displayed);
+	free(screen->dirtyStart);
+	free(screen->dirtyEnd);
+	free(screen->hashes);
+	free(screen->displayedHashes);
+	free(screen->hashesValid);
+	free(screen->displayedHashesValid);
+	free(screen->displayedLines);
+	free(screen->hashTable);
+	free(screen);
+}
+
+cc_type cc_getScreenWidth(const cc_Screen* screen) {
+	return screen->width;
+}
+
+cc_type cc_getScreenHeight(const cc_Screen* screen) {
+	return screen->height;
+}
+
+void cc_screenSetCell(cc_Screen* screen, cc_Vector2 position, cc_Cell cell) {
+	if(position.x < 0 || position.y < 0 || position.x >= screen->width || position.y >= screen->height) {
+		return;
+	}
+	if(cell.ch == '\0') {
+		cell.ch = ' ';
+	}
+	cc_screenSetPackedCell(screen, position, packCell(cell));
+}
+
+cc_Cell cc_screenGetCell(const cc_Screen* screen, cc_Vector2 position) {
+	if(position.x < 0 || position.y < 0 || position.x >= screen->width || position.y >= screen->height) {
+		return unpackCell(DEFAULT_CELL);
+	}
+	return unpackCell(screen->base[position.y * screen->width + position.x]);
+}
+
+void cc_screenSetPackedCell(cc_Screen* screen, cc_Vector2 position, cc_PackedCell cell) {
+	if(position.x < 0 || position.y < 0 || position.x >= screen->width || position.y >= screen->height) {
+		return;
+	}
+	if(cc_cellCodepoint(cell) == UNKNOWN_CODEPOINT) {
+		cell = cc_packCell(' ', cc_cellBackgroundColor(cell), cc_cellForegroundColor(cell), cc_cellAttributes(cell));
+	}
+	screen->base[position.y * screen->width + position.x] = cell;
+	damage(screen, position.x, position.y, position.x, position.y);
+}
+
+cc_PackedCell cc_screenGetPackedCell(const cc_Screen* screen, cc_Vector2 position) {
+	if(position.x < 0 || position.y < 0 || position.x >= screen->width || position.y >= screen->height) {
+		return DEFAULT_CELL;
+	}
+	return screen->base[position.y * screen->width + position.x];
+}
+
+void cc_screenPrint(cc_Screen* screen, cc_Vector2 position, const char* text, cc_Color backgroundColor,
+                    cc_Color foregroundColor) {
+	/* One cell per UTF-8 character */
+	size_t length = strlen(text);
+	for(size_t i = 0; i < length && position.x < screen->width; ++position.x) {
+		uint32_t codepoint;
+		i += cc_decodeCodepoint(&text[i], length - i, &codepoint);
+		cc_screenSetPackedCell(screen, position, cc_packCell(codepoint, backgroundColor, foregroundColor, NO_ATTRIBUTE));
+	}
+}
+
+void cc_screenFill(cc_Screen* screen, cc_Vector2 topLeft, cc_Vector2 downRight, cc_Cell cell) {
+	//orientation check
+	if(topLeft.x > downRight.x) {
+		cc_type tmp = topLeft.x;
+		topLeft.x = downRight.x;
+		downRight.x = tmp;
+	}
+	if(topLeft.y > downRight.y) {
+		cc_type tmp = topLeft.y;
+		topLeft.y = downRight.y;
+		downRight.y = tmp;
+	}
+
+	cc_Vector2 pos;
+	for(pos.y = topLeft.y; pos.y <= downRight.y; ++pos.y) {
+		for(pos.x = topLeft.x; pos.x <= downRight.x; ++pos.x) {
+			cc_screenSetCell(screen, pos, cell);
+		}
+	}
+}
+
+void cc_screenSetScrollDetection(cc_Screen* screen, bool enabled) {
+	screen->scrollDetection = enabled;
+}
+
+void cc_screenInvalidate(cc_Screen* screen) {
+	for(cc_type i = screen->width * screen->height; i--;) {
+		screen->displayed[i] = UNKNOWN_CELL;
+	}
+	setDirty(screen, 0, 0, screen->width - 1, screen->height - 1);
+}
+
+void cc_screenInvalidateRegion(cc_Screen* screen, cc_Vector2 topLeft, cc_Vector2 downRight) {
+	//orientation check
+	if(topLeft.x > downRight.x) {
+		cc_type tmp = topLeft.x;
+		topLeft.x = downRight.x;
+		downRight.x = tmp;
+	}
+	if(topLeft.y > downRight.y) {
+		cc_type tmp = topLeft.y;
+		topLeft.y = downRight.y;
+		downRight.y = tmp;
+	}
+
+	//bounds check
+	if(topLeft.x < 0) {
+		topLeft.x = 0;
+	}
+	if(topLeft.y < 0) {
+		topLeft.y = 0;
+	}
+	if(downRight.x >= screen->width) {
+		downRight.x = screen->width - 1;
+	}
+	if(downRight.y >= screen->height) {
+		downRight.y = screen->height - 1;
+	}
+
+	for(cc_type y = topLeft.y; y <= downRight.y; ++y) {
+		for(cc_type x = topLeft.x; x <= downRight.x; ++x) {
+			screen->displayed[y * screen->width + x] = UNKNOWN_CELL;
+		}
+	}
+	setDirty(screen, topLeft.x, topLeft.y, downRight.x, downRight.y);
+}
+
+void cc_screenFlush(cc_Screen* screen) {
+	cc_contextScreenFlush(cc_getCurrentContext(), screen);
+}
+
+void cc_contextScreenFlush(cc_Context* context, cc_Screen* screen) {
+	cc_contextBeginSynchronizedUpdate(context);
+	composite(screen);
+	bool scrolled = screen->scrollDetection && detectScrolls(context, screen);
+	drawDifferences(context, screen);
+	if(scrolled) {
+		/* The console scrolls the whole window again for the outputs following the flush */
+		cc_contextResetScrollRegion(context);
+	}
+	cc_contextEndSynchronizedUpdate(context);
+}
+
+bool cc_screenPresent(cc_Screen* screen) {
+	return cc_contextScreenPresent(cc_getCurrentContext(), screen);
+}
+
+bool cc_contextScreenPresent(cc_Context* context, cc_Screen* screen) {
+#ifndef OS_WINDOWS
+	/* Skip the frame while the console is late, the next presented frame replaces it */
+	size_t pending = cc_contextFlushOutput(context);
+	if(pending > 0) {
+		double rate = cc_contextOutputDrainRate(context);
+		if(rate <= 0 || (double) pending * 1000 / rate > screen->maxLatency) {
+			++screen->skippedFrames;
+			return false;
+		}
+	}
+#endif
+	cc_contextScreenFlush(context, screen);
+	return true;
+}
+
+void cc_screenSetMaxLatency(cc_Screen* screen, unsigned int milliseconds) {
+	screen->maxLatency = milliseconds;
+}
+
+unsigned long cc_screenGetSkippedFrames(const cc_Screen* screen) {
+	return screen->skippedFrames;
+}
+
+cc_Layer* cc_createLayer(cc_Screen* screen, cc_Vector2 position, cc_type width, cc_type height, int z) {
+	if(width <= 0 || height <= 0) {
+		LOG_ERROR("Invalid layer size (%dx%d)", width, height);
+		return NULL;
+	}
+
+	cc_Layer** layers = realloc(screen->layers, (screen->layersNumber + 1) * sizeof(cc_Layer*));
+	if(layers == NULL) {
+		LOG_ERROR("realloc failed");
+		return NULL;
+	}
+	screen->layers = layers;
+
+	cc_Layer* layer = malloc(sizeof(cc_Layer));
+	if(layer == NULL) {
+		LOG_ERROR("malloc failed");
+		return NULL;
+	}
+	layer->cells = malloc((size_t) (width * height) * sizeof(cc_PackedCell));
+	if(layer->cells == NULL) {
+		LOG_ERROR("malloc failed");
+		free(layer);
+		return NULL;
+	}
+	layer->screen = screen;
+	layer->position = position;
+	layer->width = width;
+	layer->height = height;
+	layer->z = z;
+	layer->visible = true;
+	screen->layers[screen->layersNumber++] = layer;
+	sortLayers(screen);
+
+	cc_layerClear(layer);
+
+	return layer;
+}
+
+void cc_destroyLayer(cc_Layer* layer) {
+	if(layer == NULL) {
+		return;
+	}
+	cc_Screen* screen = layer->screen;
+	if(layer->visible) {
+		damageLayer(layer);
+	}
+	unsigned int i = 0;
+	while(screen->layers[i] != layer) {
+		++i;
+	}
+	for(--screen->layersNumber; i < screen->layersNumber; ++i) {
+		screen->layers[i] = screen->layers[i + 1];
+	}
+	free(layer->cells);
+	free(layer);
+}
+
+void cc_layerSetPosition(cc_Layer* layer, cc_Vector2 position) {
+	if(layer->visible) {
+		damageLayer(layer);
+	}
+	layer->position = position;
+	if(layer->visible) {
+		damageLayer(layer);
+	}
+}
+
+cc_Vector2 cc_layerGetPosition(const cc_Layer* layer) {
+	return layer->position;
+}
+
+cc_type cc_getLayerWidth(const cc_Layer* layer) {
+	return layer->width;
+}
+
+cc_type cc_getLayerHeight(const cc_Layer* layer) {
+	return layer->height;
+}
+
+void cc_layerSetZ(cc_Layer* layer, int z) {
+	if(layer->z != z) {
+		layer->z = z;
+		sortLayers(layer->screen);
+		if(layer->visible) {
+			damageLayer(layer);
+		}
+	}
+}
+
+void cc_layerSetVisible(cc_Layer* layer, bool visible) {
+	if(layer->visible != visible) {
+		layer->visible = visible;
+		damageLayer(layer);
+	}
+}
+
+void cc_layerSetCell(cc_Layer* layer, cc_Vector2 position, cc_Cell cell) {
+	cc_layerSetPackedCell(layer, position, packCell(cell));
+}
+
+cc_Cell cc_layerGetCell(const cc_Layer* layer, cc_Vector2 position) {
+	return unpackCell(cc_layerGetPackedCell(layer, position));
+}
+
+void cc_layerSetPackedCell(cc_Layer* layer, cc_Vector2 position, cc_PackedCell cell) {
+	if(position.x < 0 || position.y < 0 || position.x >= layer->width || position.y >= layer->height) {
+		return;
+	}
+	layer->cells[position.y * layer->width + position.x] = cell;
+	if(layer->visible) {
+		position.x += layer->position.x;
+		position.y += layer->position.y;
+		damage(layer->screen, position.x, position.y, position.x, position.y);
+	}
+}
+
+cc_PackedCell cc_layerGetPackedCell(const cc_Layer* layer, cc_Vector2 position) {
+	if(position.x < 0 || position.y < 0 || position.x >= layer->width || position.y >= layer->height) {
+		return TRANSPARENT_CELL;
+	}
+	return layer->cells[position.y * layer->width + position.x];
+}
+
+void cc_layerPrint(cc_Layer* layer, cc_Vector2 position, const char* text, cc_Color backgroundColor,
+                   cc_Color foregroundColor) {
+	/* One cell per UTF-8 character */
+	size_t length = strlen(text);
+	for(size_t i = 0; i < length && position.x < layer->width; ++position.x) {
+		uint32_t codepoint;
+		i += cc_decodeCodepoint(&text[i], length - i, &codepoint);
+		cc_layerSetPackedCell(layer, position, cc_packCell(codepoint, backgroundColor, foregroundColor, NO_ATTRIBUTE));
+	}
+}
+
+size_t cc_decodeCodepoint(const char* bytes, size_t length, uint32_t* codepoint) {
+	unsigned char byte = (unsigned char) bytes[0];
+	size_t size;
+	uint32_t minimum;
+	if(byte < 0x80) {
+		*codepoint = byte;
+		return 1;
+	}
+	else if((byte & 0xE0) == 0xC0) {
+		*codepoint = byte & 0x1Fu;
+		size = 2;
+		minimum = 0x80;
+	}
+	else if((byte & 0xF0) == 0xE0) {
+		*codepoint = byte & 0x0Fu;
+		size = 3;
+		minimum = 0x800;
+	}
+	else if((byte & 0xF8) == 0xF0) {
+		*codepoint = byte & 0x07u;
+		size = 4;
+		minimum = 0x10000;
+	}
+	else {
+		*codepoint = 0xFFFD;
+		return 1;
+	}
+
+	/* Invalid sequences (truncated, overlong...) are shown as one replacement character per byte */
+	for(size_t i = 1; i < size; ++i) {
+		if(i >= length || ((unsigned char) bytes[i] & 0xC0) != 0x80) {
+			size = 0;
+			break;
+		}
+		*codepoint = *codepoint << 6 | ((unsigned char) bytes[i] & 0x3Fu);
+	}
+	if(size == 0 || *codepoint < minimum || *codepoint > 0x10FFFF || (*codepoint >= 0xD800 && *codepoint <= 0xDFFF)) {
+		*codepoint = 0xFFFD;
+		return 1;
+	}
+	return size;
+}
+
+void cc_layerFill(cc_Layer* layer, cc_Vector2 topLeft, cc_Vector2 downRight, cc_Cell cell) {
+	//orientation check
+	if(topLeft.x > downRight.x) {
+		cc_type tmp = topLeft.x;
+		topLeft.x = downRight.x;
+		downRight.x = tmp;
+	}
+	if(topLeft.y > downRight.y) {
+		cc_type tmp = topLeft.y;
+		topLeft.y = downRight.y;
+		downRight.y = tmp;
+	}
+
+	cc_Vector2 pos;
+	for(pos.y = topLeft.y; pos.y <= downRight.y; ++pos.y) {
+		for(pos.x = topLeft.x; pos.x <= downRight.x; ++pos.x) {
+			cc_layerSetCell(layer, pos, cell);
+		}
+	}
+}
+
+void cc_layerClear(cc_Layer* layer) {
+	for(cc_type i = layer->width * layer->height; i--;) {
+		layer->cells[i] = TRANSPARENT_CELL;
+	}
+	if(layer->visible) {
+		damageLayer(layer);
+	}
+}
@@ -0,0 +1,492 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+// For clock_gettime
+#define _POSIX_C_SOURCE 200809L
+
+#include <ConsoleControlServer.h>
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+
+// Maximal number of events taken by epoll_wait
+#define EVENTS_MAX 64
+
+// Size of the buffer the inputs are read in
+#define INPUT_BUFFER_SIZE 256
+
+// Maximal length of an incomplete key sequence kept until the next inputs (see cc_isIncompleteInput)
+#define SEQUENCE_MAX_LENGTH 8
+
+// Time without inputs after which an incomplete key sequence is decoded as it is, in milliseconds
+#define SEQUENCE_DELAY 100
+
+struct cc_Session {
+	cc_Server* server;
+	cc_Context* context;
+	int inputFd;
+	int outputFd;
+	int inputFlags; /* input file status flags when the session was added */
+	bool outputWatched; /* output file polled for writability, outputs pending */
+	char sequence[SEQUENCE_MAX_LENGTH]; /* incomplete key sequence at the end of the inputs read */
+	size_t sequenceLength;
+	struct timespec sequenceTime; /* time the incomplete sequence was read */
+	const cc_SessionHandler* handler;
+	void* data;
+	bool removed; /* removed during cc_serverRun, destroyed at its end */
+};
+
+struct cc_Server {
+	int epollFd;
+	cc_Session** sessions;
+	unsigned int sessionsNumber;
+	bool running; /* in cc_serverRun, the sessions are destroyed at its end */
+	bool removedSessions; /* sessions removed during cc_serverRun */
+	unsigned int sequencesNumber; /* sessions with an incomplete key sequence */
+};
+
+// For cc_serverRun, true if inputs were dispatched
+static bool readInputs(cc_Session* session);
+
+// For readInputs and decodeSequences, dispatch the inputs decoded from the bytes, return the number of bytes
+// decoded (an incomplete key sequence at the end is not decoded if keepSequence is true)
+static size_t dispatchInputs(cc_Session* session, const char* bytes, size_t length, bool keepSequence);
+
+// For readInputs, keep the incomplete key sequence read, or forget it if length is 0
+static void setSequence(cc_Session* session, const char* bytes, size_t length);
+
+// For cc_serverRun, time in milliseconds before the first incomplete key sequence must be decoded
+static int getSequencesDelay(const cc_Server* server);
+
+// For cc_serverRun, decode the incomplete key sequences kept for the delay, return the number of sessions which
+// received inputs
+static int decodeSequences(cc_Server* server);
+
+// For setSequence, getSequencesDelay and decodeSequences
+static long getElapsedMilliseconds(const struct timespec* time);
+
+// For readInputs, callHandler, cc_serverRun and cc_sessionFlush, send the session outputs without blocking
+static void flushOutput(cc_Session* session);
+
+// For flushOutput and destroySession
+static void watchOutput(cc_Session* session, bool watch);
+
+// For cc_serverAddSession, cc_serverRemoveSession and readInputs
+static void callHandler(cc_Session* session, void (* function)(cc_Session*));
+
+// For cc_destroyServer, cc_serverRemoveSession and cc_serverRun
+static void destroySession(cc_Session* session);
+
+bool readInputs(cc_Session* session) {
+	char buffer[SEQUENCE_MAX_LENGTH + INPUT_BUFFER_SIZE];
+	bool dispatched = false;
+	cc_Context* previousContext = cc_getCurrentContext();
+	cc_setCurrentContext(session->context);
+
+	/* Read and dispatch until no input is waiting */
+	while(!session->removed) {
+		/* The incomplete key sequence kept is completed by the bytes read */
+		size_t kept = session->sequenceLength;
+		memcpy(buffer, session->sequence, kept);
+		ssize_t n = read(session->inputFd, &buffer[kept], INPUT_BUFFER_SIZE);
+		if(n == -1 && errno == EINTR) {
+			continue;
+		}
+		if(n == -1 && errno == EAGAIN) {
+			break;
+		}
+		if(n <= 0) {
+			/* Input closed (EIO for a pseudo-terminal which master was closed) */
+			if(n == -1) {
+				LOG_INFO("Session input closed (%s)", strerror(errno));
+			}
+			cc_serverRemoveSession(session);
+			break;
+		}
+
+		size_t length = kept + (size_t) n;
+		size_t decoded = dispatchInputs(session, buffer, length, true);
+		dispatched = dispatched || decoded > 0;
+		if(!session->removed) {
+			setSequence(session, &buffer[decoded], length - decoded);
+		}
+	}
+
+	if(!session->removed) {
+		flushOutput(session);
+	}
+	cc_setCurrentContext(previousContext);
+	return dispatched;
+}
+
+size_t dispatchInputs(cc_Session* session, const char* bytes, size_t length, bool keepSequence) {
+	size_t decoded = 0;
+	while(decoded < length && !session->removed) {
+		if(keepSequence && cc_isIncompleteInput(&bytes[decoded], length - decoded)) {
+			break;
+		}
+		cc_Input input;
+		decoded += cc_decodeInput(&bytes[decoded], length - decoded, &input);
+		session->handler->input(session, input);
+	}
+	return decoded;
+}
+
+void setSequence(cc_Session* session, const char* bytes, size_t length) {
+	if(session->sequenceLength > 0) {
+		--session->server->sequencesNumber;
+	}
+	memcpy(session->sequence, bytes, length);
+	session->sequenceLength = length;
+	if(length > 0) {
+		++session->server->sequencesNumber;
+		clock_gettime(CLOCK_MONOTONIC, &session->sequenceTime);
+	}
+}
+
+int getSequencesDelay(const cc_Server* server) {
+	long delay = SEQUENCE_DELAY;
+	for(unsigned int i = 0; i < server->sessionsNumber; ++i) {
+		const cc_Session* session = server->sessions[i];
+		if(session->sequenceLength > 0) {
+			long remaining = SEQUENCE_DELAY - getElapsedMilliseconds(&session->sequenceTime);
+			if(remaining < delay) {
+				delay = remaining < 0 ? 0 : remaining;
+			}
+		}
+	}
+	return (int) delay;
+}
+
+int decodeSequences(cc_Server* server) {
+	int sessionsNumber = 0;
+	for(unsigned int i = 0; i < server->sessionsNumber; ++i) {
+		cc_Session* session = server->sessions[i];
+		if(session->sequenceLength == 0 || session->removed
+		   || getElapsedMilliseconds(&session->sequenceTime) < SEQUENCE_DELAY) {
+			continue;
+		}
+
+		/* No following bytes, the sequence is made of separate keys */
+		char sequence[SEQUENCE_MAX_LENGTH];
+		size_t length = session->sequenceLength;
+		memcpy(sequence, session->sequence, length);
+		setSequence(session, NULL, 0);
+
+		cc_Context* previousContext = cc_getCurrentContext();
+		cc_setCurrentContext(session->context);
+		dispatchInputs(session, sequence, length, false);
+		if(!session->removed) {
+			flushOutput(session);
+		}
+		cc_setCurrentContext(previousContext);
+		++sessionsNumber;
+	}
+	return sessionsNumber;
+}
+
+long getElapsedMilliseconds(const struct timespec* time) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long) (now.tv_sec - time->tv_sec) * 1000 + (now.tv_nsec - time->tv_nsec) / 1000000;
+}
+
+void flushOutput(cc_Session* session) {
+	bool pending = cc_contextFlushOutput(session->context) > 0;
+	if(pending != session->outputWatched) {
+		watchOutput(session, pending);
+	}
+}
+
+void watchOutput(cc_Session* session, bool watch) {
+	struct epoll_event event;
+	event.data.ptr = session;
+	int result;
+	if(session->outputFd == session->inputFd) {
+		event.events = watch ? EPOLLIN | EPOLLOUT : EPOLLIN;
+		result = epoll_ctl(session->server->epollFd, EPOLL_CTL_MOD, session->inputFd, &event);
+	}
+	else {
+		event.events = EPOLLOUT;
+		result = epoll_ctl(session->server->epollFd, watch ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, session->outputFd, &event);
+	}
+	if(result == -1) {
+		LOG_ERROR("epoll_ctl failed (%s)", strerror(errno));
+		return;
+	}
+	session->outputWatched = watch;
+}
+
+void callHandler(cc_Session* session, void (* function)(cc_Session*)) {
+	if(function == NULL) {
+		return;
+	}
+	cc_Context* previousContext = cc_getCurrentContext();
+	cc_setCurrentContext(session->context);
+	function(session);
+	if(!session->removed) {
+		flushOutput(session);
+	}
+	cc_setCurrentContext(previousContext);
+}
+
+void destroySession(cc_Session* session) {
+	cc_Server* server = session->server;
+	if(session->sequenceLength > 0) {
+		--server->sequencesNumber;
+	}
+	if(session->outputWatched && session->outputFd != session->inputFd) {
+		watchOutput(session, false);
+	}
+	if(epoll_ctl(server->epollFd, EPOLL_CTL_DEL, session->inputFd, NULL) == -1) {
+		LOG_ERROR("epoll_ctl failed (%s)", strerror(errno));
+	}
+	if(fcntl(session->inputFd, F_SETFL, session->inputFlags) == -1) {
+		LOG_ERROR("fcntl failed (%s)", strerror(errno));
+	}
+	cc_destroyContext(session->context);
+
+	for(unsigned int i = 0; i < server->sessionsNumber; ++i) {
+		if(server->sessions[i] == session) {
+			server->sessions[i] = server->sessions[--server->sessionsNumber];
+			break;
+		}
+	}
+	free(session);
+}
+
+cc_Server* cc_createServer() {
+	cc_Server* server = malloc(sizeof(cc_Server));
+	if(server == NULL) {
+		LOG_ERROR("malloc failed");
+		return NULL;
+	}
+
+	server->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if(server->epollFd == -1) {
+		LOG_ERROR("epoll_create1 failed (%s)", strerror(errno));
+		free(server);
+		return NULL;
+	}
+	server->sessions = NULL;
+	server->sessionsNumber = 0;
+	server->running = false;
+	server->removedSessions = false;
+	server->sequencesNumber = 0;
+	return server;
+}
+
+void cc_destroyServer(cc_Server* server) {
+	if(server == NULL) {
+		return;
+	}
+
+	while(server->sessionsNumber > 0) {
+		cc_Session* session = server->sessions[server->sessionsNumber - 1];
+		if(!session->removed) {
+			session->removed = true;
+			callHandler(session, session->handler->close);
+		}
+		destroySession(session);
+	}
+	close(server->epollFd);
+	free(server->sessions);
+	free(server);
+}
+
+cc_Session* cc_serverAddSession(cc_Server* server, int inputFd, int outputFd, const cc_SessionHandler* handler,
+                                void* data) {
+	cc_Session** sessions = realloc(server->sessions, (server->sessionsNumber + 1) * sizeof(cc_Session*));
+	if(sessions == NULL) {
+		LOG_ERROR("realloc failed");
+		return NULL;
+	}
+	server->sessions = sessions;
+
+	cc_Session* session = malloc(sizeof(cc_Session));
+	if(session == NULL) {
+		LOG_ERROR("malloc failed");
+		return NULL;
+	}
+	session->server = server;
+	session->inputFd = inputFd;
+	session->outputFd = outputFd;
+	session->outputWatched = false;
+	session->sequenceLength = 0;
+	session->handler = handler;
+	session->data = data;
+	session->removed = false;
+
+	/* The context saves the console mode before it is modified */
+	session->context = cc_createContext(inputFd, outputFd);
+	if(session->context == NULL) {
+		free(session);
+		return NULL;
+	}
+
+	/* Non-blocking output, a session not reading its outputs does not block the others */
+	cc_contextSetNonBlockingOutput(session->context, true);
+
+	/* Non blocking input, to read only the waiting inputs */
+	session->inputFlags = fcntl(inputFd, F_GETFL, 0);
+	if(session->inputFlags == -1 || fcntl(inputFd, F_SETFL, session->inputFlags | O_NONBLOCK) == -1) {
+		LOG_ERROR("fcntl failed (%s)", strerror(errno));
+		cc_destroyContext(session->context);
+		free(session);
+		return NULL;
+	}
+
+	/* Set console mode to non canonical (inputs given without waiting '\n') and no echo */
+	struct termios t;
+	if(isatty(inputFd) && tcgetattr(inputFd, &t) == 0) {
+		t.c_lflag &= ~((tcflag_t) (ICANON | ECHO));
+		t.c_cc[VMIN] = 1;
+		t.c_cc[VTIME] = 0;
+		if(tcsetattr(inputFd, TCSANOW, &t)) {
+			LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
+		}
+	}
+
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.ptr = session;
+	if(epoll_ctl(server->epollFd, EPOLL_CTL_ADD, inputFd, &event) == -1) {
+		LOG_ERROR("epoll_ctl failed (%s)", strerror(errno));
+		fcntl(inputFd, F_SETFL, session->inputFlags);
+		cc_destroyContext(session->context);
+		free(session);
+		return NULL;
+	}
+	server->sessions[server->sessionsNumber++] = session;
+
+	/* A session removed by the open function is destroyed after it returns, like from the other functions */
+	bool running = server->running;
+	server->running = true;
+	callHandler(session, handler->open);
+	server->running = running;
+	if(session->removed) {
+		if(!running) {
+			server->removedSessions = false;
+			destroySession(session);
+		}
+		return NULL;
+	}
+	return session;
+}
+
+void cc_serverRemoveSession(cc_Session* session) {
+	if(session->removed) {
+		return;
+	}
+	session->removed = true;
+	callHandler(session, session->handler->close);
+	/* Last outputs, the ones the console does not accept are lost */
+	cc_contextFlushOutput(session->context);
+
+	if(session->server->running) {
+		session->server->removedSessions = true;
+	}
+	else {
+		destroySession(session);
+	}
+}
+
+int cc_serverRun(cc_Server* server, int timeout) {
+	struct epoll_event events[EVENTS_MAX];
+	if(server->sequencesNumber > 0) {
+		/* Wake up to decode the incomplete key sequences which were not completed */
+		int delay = getSequencesDelay(server);
+		if(timeout == -1 || delay < timeout) {
+			timeout = delay;
+		}
+	}
+	int eventsNumber = epoll_wait(server->epollFd, events, EVENTS_MAX, timeout);
+	if(eventsNumber == -1) {
+		if(errno == EINTR) {
+			return 0;
+		}
+		LOG_ERROR("epoll_wait failed (%s)", strerror(errno));
+		return -1;
+	}
+
+	int sessionsNumber = 0;
+	server->running = true;
+	for(int i = 0; i < eventsNumber; ++i) {
+		cc_Session* session = events[i].data.ptr;
+		if(!session->removed && (events[i].events & EPOLLOUT)) {
+			flushOutput(session);
+			if(!session->outputWatched) {
+				callHandler(session, session->handler->drained);
+			}
+		}
+		if(!session->removed && (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+			if(readInputs(session)) {
+				++sessionsNumber;
+			}
+		}
+	}
+	if(server->sequencesNumber > 0) {
+		sessionsNumber += decodeSequences(server);
+	}
+	server->running = false;
+
+	/* Destroy the sessions removed while dispatching */
+	if(server->removedSessions) {
+		server->removedSessions = false;
+		for(unsigned int i = server->sessionsNumber; i > 0; --i) {
+			if(server->sessions[i - 1]->removed) {
+				destroySession(server->sessions[i - 1]);
+			}
+		}
+	}
+
+	return sessionsNumber;
+}
+
+unsigned int cc_serverGetSessionsNumber(const cc_Server* server) {
+	return server->sessionsNumber;
+}
+
+cc_Context* cc_sessionGetContext(const cc_Session* session) {
+	return session->context;
+}
+
+void* cc_sessionGetData(const cc_Session* session) {
+	return session->data;
+}
+
+cc_Server* cc_sessionGetServer(const cc_Session* session) {
+	return session->server;
+}
+
+void cc_sessionFlush(cc_Session* session) {
+	if(!session->removed) {
+		flushOutput(session);
+	}
+}
+
+#endif //__linux__
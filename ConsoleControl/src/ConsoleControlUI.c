@@ -87,8 +87,12 @@ static MessageDrawInfo computeTableMessageDrawInfo(const cc_Message* message, ch
 // For cc_displayTableMessage
 static void drawTableMessageChoices(const MessageDrawInfo* info, const cc_Message* message);
 
-// For cc_displayTableMessage
-static void drawTableMessage(const MessageDrawInfo* info, const cc_Message* message, char** messageLines);
+// For displayTableMessage
+static void drawTableMessage(const MessageDrawInfo* info, const cc_Message* message, char** messageLines,
+                             bool modal);
+
+// For cc_displayTableMessage and cc_displayTableModalMessage
+static void displayTableMessage(cc_Message* message, cc_Screen* screen);
 
 // For cc_displayColorMessage
 static MessageDrawInfo computeColorMessageDrawInfo(const cc_Message* message, char** messageLines,
@@ -98,9 +102,15 @@ static MessageDrawInfo computeColorMessageDrawInfo(const cc_Message* message, ch
 static void drawColorMessageChoices(const MessageDrawInfo* info, const cc_Message* message,
                                     const cc_MessageColors* colors);
 
-// For cc_displayColorMessage
+// For displayColorMessage
 static void drawColorMessage(const MessageDrawInfo* info, const cc_Message* message,
-                             char** messageLines, const cc_MessageColors* colors);
+                             char** messageLines, const cc_MessageColors* colors, bool modal);
+
+// For cc_displayColorMessage and cc_displayColorModalMessage
+static void displayColorMessage(cc_Message* message, const cc_MessageColors* colors, cc_Screen* screen);
+
+// For displayTableMessage and displayColorMessage
+static void restoreModalScreen(cc_Screen* screen, const MessageDrawInfo* info);
 
 // For changeOption
 static void changeChoicesOption(cc_ChoicesOption* choicesOption, ChangeType changeType);
@@ -159,6 +169,7 @@ MenuDrawInfo computeTableMenuDrawInfo(const cc_Menu* menu) {
 }
 
 void drawTableMenuChoices(const MenuDrawInfo* info, const cc_Menu* menu) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 pos;
 	for(unsigned int i = menu->choicesNumber; i--;) {
@@ -166,15 +177,18 @@ void drawTableMenuChoices(const MenuDrawInfo* info, const cc_Menu* menu) {
 		pos.y = info->topLeft.y + (cc_type) (4 + 2 * (i + 1));
 		cc_setCursorPosition(pos);
 		if(menu->currentChoice == i) {
-			printf("> %s <", menu->choices[i]);
+			fprintf(cc_getOutput(), "> %s <", menu->choices[i]);
 		}
 		else {
-			printf("  %s  ", menu->choices[i]);
+			fprintf(cc_getOutput(), "  %s  ", menu->choices[i]);
 		}
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
 void drawTableMenu(const MenuDrawInfo* info, const cc_Menu* menu) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 topLeft = info->topLeft;
 	cc_Vector2 downRight = {
@@ -192,7 +206,7 @@ void drawTableMenu(const MenuDrawInfo* info, const cc_Menu* menu) {
 		topLeft.y
 	};
 	cc_setCursorPosition(pos);
-	printf("%s", menu->title);
+	fprintf(cc_getOutput(), "%s", menu->title);
 	topLeft.y += 2;
 	cc_Vector2 topright = {
 		downRight.x,
@@ -202,6 +216,8 @@ void drawTableMenu(const MenuDrawInfo* info, const cc_Menu* menu) {
 
 	/* Print the choices */
 	drawTableMenuChoices(info, menu);
+
+	cc_endSynchronizedUpdate();
 }
 
 MenuDrawInfo computeColorMenuDrawInfo(const cc_Menu* menu) {
@@ -226,6 +242,7 @@ MenuDrawInfo computeColorMenuDrawInfo(const cc_Menu* menu) {
 }
 
 void drawColorMenuChoices(const MenuDrawInfo* info, const cc_Menu* menu, const cc_MenuColors* colors) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 pos;
 	pos.x = info->topLeft.x + 1;
@@ -239,20 +256,23 @@ void drawColorMenuChoices(const MenuDrawInfo* info, const cc_Menu* menu, const c
 		}
 		unsigned j = 0;
 		for(; j < (info->width - (unsigned int) strlen(menu->choices[i])) / 2; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
-		printf("%s", menu->choices[i]);
+		fprintf(cc_getOutput(), "%s", menu->choices[i]);
 		j += (unsigned int) strlen(menu->choices[i]);
 		for(; j < info->width - 1; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
 		if(menu->currentChoice == i) {
 			cc_setColors(colors->choicesBackgroundColor, colors->choicesForegroundColor);
 		}
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
 void drawColorMenu(const MenuDrawInfo* info, const cc_Menu* menu, const cc_MenuColors* colors) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 topLeft = info->topLeft;
 	cc_Vector2 downRight = { // downRight for the title
@@ -272,7 +292,7 @@ void drawColorMenu(const MenuDrawInfo* info, const cc_Menu* menu, const cc_MenuC
 		topLeft.y
 	};
 	cc_setCursorPosition(pos);
-	printf("%s", menu->title);
+	fprintf(cc_getOutput(), "%s", menu->title);
 
 	/* If same background color for title and choices, draw a line */
 	if(colors->titleBackgroundColor == colors->choicesBackgroundColor) {
@@ -293,6 +313,8 @@ void drawColorMenu(const MenuDrawInfo* info, const cc_Menu* menu, const cc_MenuC
 
 	/* Print the choices */
 	drawColorMenuChoices(info, menu, colors);
+
+	cc_endSynchronizedUpdate();
 }
 
 bool messageHasChoices(const cc_Message* message) {
@@ -374,6 +396,8 @@ MessageDrawInfo computeTableMessageDrawInfo(const cc_Message* message, char** me
 }
 
 void drawTableMessageChoices(const MessageDrawInfo* info, const cc_Message* message) {
+	cc_beginSynchronizedUpdate();
+
 	cc_Vector2 pos;
 	pos.y = info->topLeft.y + (int) (info->linesNumber + 3 + (unsigned int) (4 * info->hasTitle));
 	/* Left choice */
@@ -381,10 +405,10 @@ void drawTableMessageChoices(const MessageDrawInfo* info, const cc_Message* mess
 		pos.x = (int) (info->leftChoicePosX);
 		cc_setCursorPosition(pos);
 		if(message->currentChoice == LEFT_CHOICE) {
-			printf("> %s <", message->leftChoice);
+			fprintf(cc_getOutput(), "> %s <", message->leftChoice);
 		}
 		else {
-			printf("  %s  ", message->leftChoice);
+			fprintf(cc_getOutput(), "  %s  ", message->leftChoice);
 		}
 	}
 	/* Middle choice */
@@ -392,10 +416,10 @@ void drawTableMessageChoices(const MessageDrawInfo* info, const cc_Message* mess
 		pos.x = (int) (info->middleChoicePosX);
 		cc_setCursorPosition(pos);
 		if(message->currentChoice == MIDDLE_CHOICE) {
-			printf("> %s <", message->middleChoice);
+			fprintf(cc_getOutput(), "> %s <", message->middleChoice);
 		}
 		else {
-			printf("  %s  ", message->middleChoice);
+			fprintf(cc_getOutput(), "  %s  ", message->middleChoice);
 		}
 	}
 	/* Right choice */
@@ -403,15 +427,18 @@ void drawTableMessageChoices(const MessageDrawInfo* info, const cc_Message* mess
 		pos.x = (int) (info->rightChoicePosX);
 		cc_setCursorPosition(pos);
 		if(message->currentChoice == RIGHT_CHOICE) {
-			printf("> %s <", message->rightChoice);
+			fprintf(cc_getOutput(), "> %s <", message->rightChoice);
 		}
 		else {
-			printf("  %s  ", message->rightChoice);
+			fprintf(cc_getOutput(), "  %s  ", message->rightChoice);
 		}
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
-void drawTableMessage(const MessageDrawInfo* info, const cc_Message* message, char** messageLines) {
+void drawTableMessage(const MessageDrawInfo* info, const cc_Message* message, char** messageLines, bool modal) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 topLeft = info->topLeft;
 	cc_Vector2 downRight = {
@@ -419,7 +446,12 @@ void drawTableMessage(const MessageDrawInfo* info, const cc_Message* message, ch
 		topLeft.y + (cc_type) info->height
 	};
 
-	cc_clean();
+	if(modal) {
+		cc_drawFullRectangle(topLeft, downRight, ' ');
+	}
+	else {
+		cc_clean();
+	}
 
 	/* Print table and title */
 	cc_drawTableRectangle(topLeft, downRight);
@@ -430,7 +462,7 @@ void drawTableMessage(const MessageDrawInfo* info, const cc_Message* message, ch
 			topLeft.y
 		};
 		cc_setCursorPosition(pos);
-		printf("%s", message->title);
+		fprintf(cc_getOutput(), "%s", message->title);
 		topLeft.y += 2;
 		cc_Vector2 titleDownRight = {
 			downRight.x,
@@ -445,13 +477,15 @@ void drawTableMessage(const MessageDrawInfo* info, const cc_Message* message, ch
 		--topLeft.y;
 		topLeft.x = info->topLeft.x + 1 + (int) (info->width - (unsigned int) strlen(messageLines[i])) / 2;
 		cc_setCursorPosition(topLeft);
-		printf("%s", messageLines[i]);
+		fprintf(cc_getOutput(), "%s", messageLines[i]);
 	}
 
 	/* Print the choices */
 	if(info->hasChoices) {
 		drawTableMessageChoices(info, message);
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
 MessageDrawInfo computeColorMessageDrawInfo(const cc_Message* message, char** messageLines, unsigned int linesNumber) {
@@ -527,6 +561,8 @@ MessageDrawInfo computeColorMessageDrawInfo(const cc_Message* message, char** me
 }
 
 void drawColorMessageChoices(const MessageDrawInfo* info, const cc_Message* message, const cc_MessageColors* colors) {
+	cc_beginSynchronizedUpdate();
+
 	cc_Vector2 pos;
 	pos.y = info->topLeft.y + (int) (info->linesNumber + 2 + (unsigned int) (3 * info->hasTitle));
 	/* Left choice */
@@ -539,7 +575,7 @@ void drawColorMessageChoices(const MessageDrawInfo* info, const cc_Message* mess
 		else {
 			cc_setColors(colors->choicesBackgroundColor, colors->choicesForegroundColor);
 		}
-		printf(" %s ", message->leftChoice);
+		fprintf(cc_getOutput(), " %s ", message->leftChoice);
 	}
 	/* Middle choice */
 	if(message->middleChoice != NULL && message->middleChoice[0] != '\0') {
@@ -551,7 +587,7 @@ void drawColorMessageChoices(const MessageDrawInfo* info, const cc_Message* mess
 		else {
 			cc_setColors(colors->choicesBackgroundColor, colors->choicesForegroundColor);
 		}
-		printf(" %s ", message->middleChoice);
+		fprintf(cc_getOutput(), " %s ", message->middleChoice);
 	}
 	/* Right choice */
 	if(message->rightChoice != NULL && message->rightChoice[0] != '\0') {
@@ -563,12 +599,15 @@ void drawColorMessageChoices(const MessageDrawInfo* info, const cc_Message* mess
 		else {
 			cc_setColors(colors->choicesBackgroundColor, colors->choicesForegroundColor);
 		}
-		printf(" %s ", message->rightChoice);
+		fprintf(cc_getOutput(), " %s ", message->rightChoice);
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
 void drawColorMessage(const MessageDrawInfo* info, const cc_Message* message,
-                      char** messageLines, const cc_MessageColors* colors) {
+                      char** messageLines, const cc_MessageColors* colors, bool modal) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 topLeft = info->topLeft;
 	cc_Vector2 downRight = { // downRight for the title
@@ -576,8 +615,10 @@ void drawColorMessage(const MessageDrawInfo* info, const cc_Message* message,
 		topLeft.y + 3
 	};
 
-	cc_setBackgroundColor(colors->mainBackgroundColor);
-	cc_clean();
+	if(!modal) {
+		cc_setBackgroundColor(colors->mainBackgroundColor);
+		cc_clean();
+	}
 
 	/* Print the title background and text */
 	if(info->hasTitle) {
@@ -589,7 +630,7 @@ void drawColorMessage(const MessageDrawInfo* info, const cc_Message* message,
 			topLeft.y
 		};
 		cc_setCursorPosition(pos);
-		printf("%s", message->title);
+		fprintf(cc_getOutput(), "%s", message->title);
 
 		/* If same background color for title and choices, draw a line */
 		if(colors->titleBackgroundColor == colors->choicesBackgroundColor) {
@@ -615,13 +656,15 @@ void drawColorMessage(const MessageDrawInfo* info, const cc_Message* message,
 		--topLeft.y;
 		topLeft.x = info->topLeft.x + 1 + (int) (info->width - (unsigned int) strlen(messageLines[i])) / 2;
 		cc_setCursorPosition(topLeft);
-		printf("%s", messageLines[i]);
+		fprintf(cc_getOutput(), "%s", messageLines[i]);
 	}
 
 	/* Print the choices */
 	if(info->hasChoices) {
 		drawColorMessageChoices(info, message, colors);
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
 void changeChoicesOption(cc_ChoicesOption* choicesOption, ChangeType changeType) {
@@ -776,6 +819,8 @@ OptionMenuDrawInfo computeTableOptionMenuDrawInfo(const cc_OptionsMenu* optionsM
 }
 
 void drawTableOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_OptionsMenu* optionsMenu) {
+	cc_beginSynchronizedUpdate();
+
 	cc_Vector2 pos;
 	pos.x = info->topLeft.x + 1;
 	pos.y = info->topLeft.y + (cc_type) (6 + 3 * optionsMenu->optionsNumber);
@@ -787,22 +832,22 @@ void drawTableOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_Options
 	if(optionsMenu->selectedOption == optionsMenu->optionsNumber) {
 		len += 4;
 		for(; j < (info->width - len) / 2; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
-		printf("> %s <", optionsMenu->exitText);
+		fprintf(cc_getOutput(), "> %s <", optionsMenu->exitText);
 		j += len;
 		for(; j < info->width - 1; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
 	}
 	else {
 		for(; j < (info->width - len) / 2; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
-		printf("%s", optionsMenu->exitText);
+		fprintf(cc_getOutput(), "%s", optionsMenu->exitText);
 		j += len;
 		for(; j < info->width - 1; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
 	}
 
@@ -814,24 +859,24 @@ void drawTableOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_Options
 			len = (unsigned int) strlen(optionsMenu->options[i]->name) + 4;
 			j = 0;
 			for(; j < (info->width - len) / 2; ++j) {
-				putchar(' ');
+				putc(' ', cc_getOutput());
 			}
-			printf("> %s <", optionsMenu->options[i]->name);
+			fprintf(cc_getOutput(), "> %s <", optionsMenu->options[i]->name);
 			j += len;
 			for(; j < info->width - 1; ++j) {
-				putchar(' ');
+				putc(' ', cc_getOutput());
 			}
 		}
 		else {
 			len = (unsigned int) strlen(optionsMenu->options[i]->name);
 			j = 0;
 			for(; j < (info->width - len) / 2; ++j) {
-				putchar(' ');
+				putc(' ', cc_getOutput());
 			}
-			printf("%s", optionsMenu->options[i]->name);
+			fprintf(cc_getOutput(), "%s", optionsMenu->options[i]->name);
 			j += len;
 			for(; j < info->width - 1; ++j) {
-				putchar(' ');
+				putc(' ', cc_getOutput());
 			}
 		}
 
@@ -844,13 +889,13 @@ void drawTableOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_Options
 					                            ->choices[optionsMenu->options[i]->choicesOption->currentChoice]) + 4;
 				j = 0;
 				for(; j < (info->width - len) / 2; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				printf("{ %s }", optionsMenu->options[i]->choicesOption
+				fprintf(cc_getOutput(), "{ %s }", optionsMenu->options[i]->choicesOption
 					->choices[optionsMenu->options[i]->choicesOption->currentChoice]);
 				j += len;
 				for(; j < info->width - 1; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
 			}
 				break;
@@ -858,12 +903,12 @@ void drawTableOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_Options
 				len = intLen(optionsMenu->options[i]->integerOption->value) + 4;
 				j = 0;
 				for(; j < (info->width - len) / 2; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				printf("{ %d }", optionsMenu->options[i]->integerOption->value);
+				fprintf(cc_getOutput(), "{ %d }", optionsMenu->options[i]->integerOption->value);
 				j += len;
 				for(; j < info->width - 1; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
 			}
 				break;
@@ -871,12 +916,12 @@ void drawTableOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_Options
 				len = 5;
 				j = 0;
 				for(; j < (info->width - len) / 2; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				printf("{ %c }", optionsMenu->options[i]->characterOption->value);
+				fprintf(cc_getOutput(), "{ %c }", optionsMenu->options[i]->characterOption->value);
 				j += len;
 				for(; j < info->width - 1; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
 			}
 				break;
@@ -884,9 +929,12 @@ void drawTableOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_Options
 				break;
 		}
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
 void drawTableOptionMenu(const OptionMenuDrawInfo* info, const cc_OptionsMenu* optionsMenu) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 topLeft = info->topLeft;
 	cc_Vector2 downRight = {
@@ -904,7 +952,7 @@ void drawTableOptionMenu(const OptionMenuDrawInfo* info, const cc_OptionsMenu* o
 		topLeft.y
 	};
 	cc_setCursorPosition(pos);
-	printf("%s", optionsMenu->title);
+	fprintf(cc_getOutput(), "%s", optionsMenu->title);
 	topLeft.y += 2;
 	cc_Vector2 topright = {
 		downRight.x,
@@ -914,6 +962,8 @@ void drawTableOptionMenu(const OptionMenuDrawInfo* info, const cc_OptionsMenu* o
 
 	/* Print the choices */
 	drawTableOptionMenuOptions(info, optionsMenu);
+
+	cc_endSynchronizedUpdate();
 }
 
 static OptionMenuDrawInfo computeColorOptionMenuDrawInfo(const cc_OptionsMenu* optionsMenu) {
@@ -973,6 +1023,8 @@ static OptionMenuDrawInfo computeColorOptionMenuDrawInfo(const cc_OptionsMenu* o
 
 static void drawColorOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_OptionsMenu* optionsMenu,
                                        const cc_MenuColors* colors) {
+	cc_beginSynchronizedUpdate();
+
 	cc_Vector2 pos;
 	pos.x = info->topLeft.x + 1;
 	pos.y = info->topLeft.y + (cc_type) (4 + 3 * optionsMenu->optionsNumber);
@@ -989,12 +1041,12 @@ static void drawColorOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_
 	unsigned int j = 0;
 
 	for(; j < (info->width - len) / 2; ++j) {
-		putchar(' ');
+		putc(' ', cc_getOutput());
 	}
-	printf("%s", optionsMenu->exitText);
+	fprintf(cc_getOutput(), "%s", optionsMenu->exitText);
 	j += len;
 	for(; j < info->width - 1; ++j) {
-		putchar(' ');
+		putc(' ', cc_getOutput());
 	}
 
 	if(optionsMenu->selectedOption == optionsMenu->optionsNumber) {
@@ -1012,12 +1064,12 @@ static void drawColorOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_
 		len = (unsigned int) strlen(optionsMenu->options[i]->name);
 		j = 0;
 		for(; j < (info->width - len) / 2; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
-		printf("%s", optionsMenu->options[i]->name);
+		fprintf(cc_getOutput(), "%s", optionsMenu->options[i]->name);
 		j += len;
 		for(; j < info->width - 1; ++j) {
-			putchar(' ');
+			putc(' ', cc_getOutput());
 		}
 
 		++pos.y;
@@ -1027,54 +1079,54 @@ static void drawColorOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_
 			case CHOICES_OPTION: {
 				len = (unsigned int) strlen(optionsMenu->options[i]->choicesOption
 					                            ->choices[optionsMenu->options[i]->choicesOption->currentChoice]);
-				putchar(' ');
-				putchar('<');
+				putc(' ', cc_getOutput());
+				putc('<', cc_getOutput());
 				j = 2;
 				for(; j < (info->width - len) / 2; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				printf("%s", optionsMenu->options[i]->choicesOption
+				fprintf(cc_getOutput(), "%s", optionsMenu->options[i]->choicesOption
 					->choices[optionsMenu->options[i]->choicesOption->currentChoice]);
 				j += len;
 				for(; j < info->width - 3; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				putchar('>');
-				putchar(' ');
+				putc('>', cc_getOutput());
+				putc(' ', cc_getOutput());
 			}
 				break;
 			case INTEGER_OPTION: {
 				len = intLen(optionsMenu->options[i]->integerOption->value);
-				putchar(' ');
-				putchar('<');
+				putc(' ', cc_getOutput());
+				putc('<', cc_getOutput());
 				j = 2;
 				for(; j < (info->width - len) / 2; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				printf("%d", optionsMenu->options[i]->integerOption->value);
+				fprintf(cc_getOutput(), "%d", optionsMenu->options[i]->integerOption->value);
 				j += len;
 				for(; j < info->width - 3; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				putchar('>');
-				putchar(' ');
+				putc('>', cc_getOutput());
+				putc(' ', cc_getOutput());
 			}
 				break;
 			case CHARACTER_OPTION: {
 				len = 1;
-				putchar(' ');
-				putchar('<');
+				putc(' ', cc_getOutput());
+				putc('<', cc_getOutput());
 				j = 2;
 				for(; j < (info->width - len) / 2; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				printf("%c", optionsMenu->options[i]->characterOption->value);
+				fprintf(cc_getOutput(), "%c", optionsMenu->options[i]->characterOption->value);
 				j += len;
 				for(; j < info->width - 3; ++j) {
-					putchar(' ');
+					putc(' ', cc_getOutput());
 				}
-				putchar('>');
-				putchar(' ');
+				putc('>', cc_getOutput());
+				putc(' ', cc_getOutput());
 			}
 				break;
 			default:
@@ -1085,10 +1137,13 @@ static void drawColorOptionMenuOptions(const OptionMenuDrawInfo* info, const cc_
 			cc_setColors(colors->choicesBackgroundColor, colors->choicesForegroundColor);
 		}
 	}
+
+	cc_endSynchronizedUpdate();
 }
 
 static void drawColorOptionMenu(const OptionMenuDrawInfo* info, const cc_OptionsMenu* optionsMenu,
                                 const cc_MenuColors* colors) {
+	cc_beginSynchronizedUpdate();
 
 	cc_Vector2 topLeft = info->topLeft;
 	cc_Vector2 downRight = { // downRight for the title
@@ -1108,7 +1163,7 @@ static void drawColorOptionMenu(const OptionMenuDrawInfo* info, const cc_Options
 		topLeft.y
 	};
 	cc_setCursorPosition(pos);
-	printf("%s", optionsMenu->title);
+	fprintf(cc_getOutput(), "%s", optionsMenu->title);
 
 	/* If same background color for title and choices, draw a line */
 	if(colors->titleBackgroundColor == colors->choicesBackgroundColor) {
@@ -1129,6 +1184,8 @@ static void drawColorOptionMenu(const OptionMenuDrawInfo* info, const cc_Options
 
 	/* Print the choices */
 	drawColorOptionMenuOptions(info, optionsMenu, colors);
+
+	cc_endSynchronizedUpdate();
 }
 
 void cc_displayTableMenu(cc_Menu* menu) {
@@ -1158,6 +1215,8 @@ void cc_displayTableMenu(cc_Menu* menu) {
 
 	MenuDrawInfo info = computeTableMenuDrawInfo(menu);
 
+	cc_enterAlternateScreen();
+
 	/* Display menu */
 	drawTableMenu(&info, menu);
 
@@ -1236,6 +1295,7 @@ void cc_displayTableMenu(cc_Menu* menu) {
 	}
 
 	cc_setCursorPosition(nullpos);
+	cc_leaveAlternateScreen();
 }
 
 void cc_displayColorMenu(cc_Menu* menu, const cc_MenuColors* colors) {
@@ -1265,6 +1325,8 @@ void cc_displayColorMenu(cc_Menu* menu, const cc_MenuColors* colors) {
 
 	MenuDrawInfo info = computeColorMenuDrawInfo(menu);
 
+	cc_enterAlternateScreen();
+
 	/* Display menu */
 	drawColorMenu(&info, menu, colors);
 
@@ -1343,9 +1405,18 @@ void cc_displayColorMenu(cc_Menu* menu, const cc_MenuColors* colors) {
 	}
 
 	cc_setCursorPosition(nullpos);
+	cc_leaveAlternateScreen();
 }
 
 void cc_displayTableMessage(cc_Message* message) {
+	displayTableMessage(message, NULL);
+}
+
+void cc_displayTableModalMessage(cc_Message* message, cc_Screen* screen) {
+	displayTableMessage(message, screen);
+}
+
+void displayTableMessage(cc_Message* message, cc_Screen* screen) {
 
 	if(message->message == NULL) {
 		LOG_ERROR("Message message field is NULL");
@@ -1412,8 +1483,12 @@ void cc_displayTableMessage(cc_Message* message) {
 		message->currentChoice = NO_CHOICE;
 	}
 
+	if(screen == NULL) {
+		cc_enterAlternateScreen();
+	}
+
 	/* Display message */
-	drawTableMessage(&info, message, messageLines);
+	drawTableMessage(&info, message, messageLines, screen != NULL);
 
 	/* Main loop */
 	cc_displayInputs(false);
@@ -1497,8 +1572,12 @@ void cc_displayTableMessage(cc_Message* message) {
 		else {
 			usedWidth = consoleWidth;
 			usedHeight = consoleHeight;
+			if(screen != NULL) {
+				cc_screenInvalidate(screen);
+				cc_screenFlush(screen);
+			}
 			info = computeTableMessageDrawInfo(message, messageLines, linesNumber);
-			drawTableMessage(&info, message, messageLines);
+			drawTableMessage(&info, message, messageLines, screen != NULL);
 		}
 	}
 
@@ -1508,10 +1587,24 @@ void cc_displayTableMessage(cc_Message* message) {
 	free(messageLines[0]);
 	free(messageLines);
 
-	cc_setCursorPosition(nullpos);
+	if(screen != NULL) {
+		restoreModalScreen(screen, &info);
+	}
+	else {
+		cc_setCursorPosition(nullpos);
+		cc_leaveAlternateScreen();
+	}
 }
 
 void cc_displayColorMessage(cc_Message* message, const cc_MessageColors* colors) {
+	displayColorMessage(message, colors, NULL);
+}
+
+void cc_displayColorModalMessage(cc_Message* message, const cc_MessageColors* colors, cc_Screen* screen) {
+	displayColorMessage(message, colors, screen);
+}
+
+void displayColorMessage(cc_Message* message, const cc_MessageColors* colors, cc_Screen* screen) {
 
 	if(message->message == NULL) {
 		LOG_ERROR("Message message field is NULL");
@@ -1578,8 +1671,12 @@ void cc_displayColorMessage(cc_Message* message, const cc_MessageColors* colors)
 		message->currentChoice = NO_CHOICE;
 	}
 
+	if(screen == NULL) {
+		cc_enterAlternateScreen();
+	}
+
 	/* Display message */
-	drawColorMessage(&info, message, messageLines, colors);
+	drawColorMessage(&info, message, messageLines, colors, screen != NULL);
 
 	/* Main loop */
 	cc_displayInputs(false);
@@ -1663,8 +1760,12 @@ void cc_displayColorMessage(cc_Message* message, const cc_MessageColors* colors)
 		else {
 			usedWidth = consoleWidth;
 			usedHeight = consoleHeight;
+			if(screen != NULL) {
+				cc_screenInvalidate(screen);
+				cc_screenFlush(screen);
+			}
 			info = computeColorMessageDrawInfo(message, messageLines, linesNumber);
-			drawColorMessage(&info, message, messageLines, colors);
+			drawColorMessage(&info, message, messageLines, colors, screen != NULL);
 		}
 	}
 
@@ -1674,7 +1775,22 @@ void cc_displayColorMessage(cc_Message* message, const cc_MessageColors* colors)
 	free(messageLines[0]);
 	free(messageLines);
 
-	cc_setCursorPosition(nullpos);
+	if(screen != NULL) {
+		restoreModalScreen(screen, &info);
+	}
+	else {
+		cc_setCursorPosition(nullpos);
+		cc_leaveAlternateScreen();
+	}
+}
+
+void restoreModalScreen(cc_Screen* screen, const MessageDrawInfo* info) {
+	cc_Vector2 downRight = {
+		info->topLeft.x + (cc_type) info->width,
+		info->topLeft.y + (cc_type) info->height
+	};
+	cc_screenInvalidateRegion(screen, info->topLeft, downRight);
+	cc_screenFlush(screen);
 }
 
 void cc_displayTableOptionMenu(cc_OptionsMenu* optionsMenu) {
@@ -1799,6 +1915,8 @@ void cc_displayTableOptionMenu(cc_OptionsMenu* optionsMenu) {
 
 	OptionMenuDrawInfo info = computeTableOptionMenuDrawInfo(optionsMenu);
 
+	cc_enterAlternateScreen();
+
 	/* Display menu */
 	drawTableOptionMenu(&info, optionsMenu);
 
@@ -1893,6 +2011,7 @@ void cc_displayTableOptionMenu(cc_OptionsMenu* optionsMenu) {
 	}
 
 	cc_setCursorPosition(nullpos);
+	cc_leaveAlternateScreen();
 }
 
 void cc_displayColorOptionMenu(cc_OptionsMenu* optionsMenu, const cc_MenuColors* colors) {
@@ -2017,6 +2136,8 @@ void cc_displayColorOptionMenu(cc_OptionsMenu* optionsMenu, const cc_MenuColors*
 
 	OptionMenuDrawInfo info = computeColorOptionMenuDrawInfo(optionsMenu);
 
+	cc_enterAlternateScreen();
+
 	/* Display menu */
 	drawColorOptionMenu(&info, optionsMenu, colors);
 
@@ -2111,4 +2232,5 @@ void cc_displayColorOptionMenu(cc_OptionsMenu* optionsMenu, const cc_MenuColors*
 	}
 
 	cc_setCursorPosition(nullpos);
+	cc_leaveAlternateScreen();
 }
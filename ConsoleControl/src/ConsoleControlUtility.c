@@ -66,7 +66,7 @@ void cc_drawRectangle(cc_Vector2 topLeft, cc_Vector2 downRight, const char ch) {
 	//top line
 	cc_setCursorPosition(topLeft);
 	for(cc_type i = topLeft.x; i <= downRight.x; ++i) {
-		putchar(ch);
+		putc(ch, cc_getOutput());
 	}
 
 	// right and left lines
@@ -74,10 +74,10 @@ void cc_drawRectangle(cc_Vector2 topLeft, cc_Vector2 downRight, const char ch) {
 	for(pos.y = topLeft.y + 1; pos.y < downRight.y; ++pos.y) {
 		pos.x = topLeft.x;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 		pos.x = downRight.x;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 	}
 
 	//bottom line
@@ -85,7 +85,7 @@ void cc_drawRectangle(cc_Vector2 topLeft, cc_Vector2 downRight, const char ch) {
 		pos.x = topLeft.x;
 		cc_setCursorPosition(pos);
 		for(cc_type i = topLeft.x; i <= downRight.x; ++i) {
-			putchar(ch);
+			putc(ch, cc_getOutput());
 		}
 	}
 }
@@ -105,31 +105,31 @@ void cc_drawTableRectangle(cc_Vector2 topLeft, cc_Vector2 downRight) {
 
 	//top line
 	cc_setCursorPosition(topLeft);
-	putchar('+');
+	putc('+', cc_getOutput());
 	for(cc_type i = topLeft.x + 1; i < downRight.x; ++i) {
-		putchar('-');
+		putc('-', cc_getOutput());
 	}
-	putchar('+');
+	putc('+', cc_getOutput());
 
 	// right and left lines
 	cc_Vector2 pos;
 	for(pos.y = topLeft.y + 1; pos.y < downRight.y; ++pos.y) {
 		pos.x = topLeft.x;
 		cc_setCursorPosition(pos);
-		putchar('|');
+		putc('|', cc_getOutput());
 		pos.x = downRight.x;
 		cc_setCursorPosition(pos);
-		putchar('|');
+		putc('|', cc_getOutput());
 	}
 
 	//bottom line
 	pos.x = topLeft.x;
 	cc_setCursorPosition(pos);
-	putchar('+');
+	putc('+', cc_getOutput());
 	for(cc_type i = topLeft.x + 1; i < downRight.x; ++i) {
-		putchar('-');
+		putc('-', cc_getOutput());
 	}
-	putchar('+');
+	putc('+', cc_getOutput());
 }
 
 void cc_drawFullRectangle(cc_Vector2 topLeft, cc_Vector2 downRight, const char ch) {
@@ -150,61 +150,61 @@ void cc_drawFullRectangle(cc_Vector2 topLeft, cc_Vector2 downRight, const char c
 	for(pos.y = topLeft.y; pos.y <= downRight.y; ++pos.y) {
 		cc_setCursorPosition(pos);
 		for(cc_type i = topLeft.x; i <= downRight.x; ++i) {
-			putchar(ch);
+			putc(ch, cc_getOutput());
 		}
 	}
 }
 
 void cc_drawLine(cc_Vector2 from, cc_Vector2 to, const char ch) {
 	cc_setCursorPosition(from);
-	putchar(ch);
+	putc(ch, cc_getOutput());
 	cc_type n = dist(from, to);
 	if(n) {
 		double t;
 		for(double i = 1; i <= n; ++i) {
 			t = i / n;
 			cc_setCursorPosition(vectlerp(from, to, t));
-			putchar(ch);
+			putc(ch, cc_getOutput());
 		}
 	}
 }
 
 void cc_drawTableHorizontalLine(cc_Vector2 from, cc_Vector2 to) {
 	cc_setCursorPosition(from);
-	putchar('+');
+	putc('+', cc_getOutput());
 	cc_type n = dist(from, to);
 	if(n) {
 		double t;
 		for(double i = 1; i < n; ++i) {
 			t = i / n;
 			cc_setCursorPosition(vectlerp(from, to, t));
-			putchar('-');
+			putc('-', cc_getOutput());
 		}
 		cc_setCursorPosition(vectlerp(from, to, 1));
-		putchar('+');
+		putc('+', cc_getOutput());
 	}
 }
 
 void cc_drawTableVerticalLine(cc_Vector2 from, cc_Vector2 to) {
 	cc_setCursorPosition(from);
-	putchar('+');
+	putc('+', cc_getOutput());
 	cc_type n = dist(from, to);
 	if(n) {
 		double t;
 		for(double i = 1; i < n; ++i) {
 			t = i / n;
 			cc_setCursorPosition(vectlerp(from, to, t));
-			putchar('|');
+			putc('|', cc_getOutput());
 		}
 		cc_setCursorPosition(vectlerp(from, to, 1));
-		putchar('+');
+		putc('+', cc_getOutput());
 	}
 }
 
 void cc_drawPatternLine(cc_Vector2 from, cc_Vector2 to, const char* pattern) {
 	unsigned int chNumber = 0;
 	cc_setCursorPosition(from);
-	putchar(pattern[chNumber]);
+	putc(pattern[chNumber], cc_getOutput());
 	cc_type n = dist(from, to);
 	if(n) {
 		double t;
@@ -214,7 +214,7 @@ void cc_drawPatternLine(cc_Vector2 from, cc_Vector2 to, const char* pattern) {
 			if(pattern[++chNumber] == '\0') {
 				chNumber = 0;
 			}
-			putchar(pattern[chNumber]);
+			putc(pattern[chNumber], cc_getOutput());
 		}
 	}
 }
@@ -229,34 +229,34 @@ void cc_drawCircle(cc_Vector2 center, unsigned int radius, char ch) {
 		pos.x = center.x + x;
 		pos.y = center.y + y;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 		pos.y = center.y - y;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 
 		pos.x = center.x + y;
 		pos.y = center.y + x;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 		pos.y = center.y - x;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 
 		pos.x = center.x - y;
 		pos.y = center.y + x;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 		pos.y = center.y - x;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 
 		pos.x = center.x - x;
 		pos.y = center.y + y;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 		pos.y = center.y - y;
 		cc_setCursorPosition(pos);
-		putchar(ch);
+		putc(ch, cc_getOutput());
 
 		if(err <= 0) {
 			++y;
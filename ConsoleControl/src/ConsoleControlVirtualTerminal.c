@@ -0,0 +1,1222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+// For posix_openpt, grantpt, unlockpt and ptsname
+#define _XOPEN_SOURCE 600
+
+#include <ConsoleControlVirtualTerminal.h>
+#include <UnixConsoleControl.h>
+
+#ifndef OS_WINDOWS
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+
+// Maximum number of parameters of a control sequence, the next ones are ignored
+#define MAX_PARAMETERS 16
+
+// Application program command written by cc_virtualTerminalSync after the outputs, followed by a number
+#define SYNC_COMMAND "cc-sync;"
+
+typedef enum {
+	GROUND_STATE, /* characters */
+	ESCAPE_STATE, /* after ESC */
+	ESCAPE_INTERMEDIATE_STATE, /* after ESC and an intermediate byte (character set selection...) */
+	CSI_STATE, /* control sequence parameters */
+	STRING_STATE, /* command string (OSC, DCS, APC...), ignored until the string terminator */
+	STRING_ESCAPE_STATE /* ESC in a command string */
+} ParserState;
+
+typedef struct {
+	cc_Vector2 position;
+	cc_Color backgroundColor;
+	cc_Color foregroundColor;
+	unsigned int attributes;
+} SavedCursor;
+
+struct cc_VirtualTerminal {
+	int master;
+	int slave;
+	cc_Context* context;
+	pthread_t thread; /* reads the outputs from the pseudo-terminal master and interprets them */
+	pthread_mutex_t mutex; /* protects the cells and the parser, locked by the thread */
+	pthread_cond_t synchronized; /* signaled when a synchronization command is received */
+	cc_type width;
+	cc_type height;
+	cc_PackedCell* cells; /* displayed cells */
+	cc_PackedCell* otherCells; /* main screen cells in the alternate screen, alternate screen cells otherwise */
+	bool alternateScreen;
+	bool synchronizedUpdate; /* synchronized update mode set, given in the replies to the mode requests */
+	cc_Vector2 cursor;
+	bool wrapPending; /* character written in the last column, the next one is written on the next line */
+	SavedCursor savedCursor;
+	SavedCursor alternateSavedCursor; /* cursor saved when entering the alternate screen */
+	cc_type scrollTop;
+	cc_type scrollBottom;
+	cc_Color backgroundColor;
+	cc_Color foregroundColor;
+	unsigned int attributes;
+	ParserState state;
+	uint32_t codepoint; /* UTF-8 character being decoded */
+	unsigned int codepointBytes; /* continuation bytes expected */
+	unsigned int parameters[MAX_PARAMETERS];
+	unsigned int parametersNumber;
+	char privateMarker;
+	char intermediate;
+	bool command; /* command string is an application program command, kept */
+	char commandString[32];
+	size_t commandLength;
+	unsigned long long received; /* output bytes received, without the synchronization commands */
+	unsigned int syncRequested; /* number of the last synchronization command written */
+	unsigned int syncReceived; /* number of the last synchronization command received */
+	bool closed; /* thread stopped, the outputs are not read anymore */
+};
+
+// For cc_createVirtualTerminal, thread function
+static void* readOutputs(void* data);
+
+// For readOutputs, interpret an output byte
+static void parseByte(cc_VirtualTerminal* terminal, unsigned char byte);
+
+// For parseByte, control characters
+static void executeControl(cc_VirtualTerminal* terminal, unsigned char byte);
+
+// For parseByte, escape sequences
+static void executeEscape(cc_VirtualTerminal* terminal, unsigned char byte);
+
+// For parseByte, control sequences
+static void executeControlSequence(cc_VirtualTerminal* terminal, unsigned char final);
+
+// For executeControlSequence, select graphic rendition
+static void setGraphicRendition(cc_VirtualTerminal* terminal);
+
+// For executeControlSequence, private modes
+static void setMode(cc_VirtualTerminal* terminal, bool enabled);
+
+// For executeControlSequence, reply to a private mode request (DECRQM)
+static void reportMode(cc_VirtualTerminal* terminal);
+
+// For parseByte, application program commands
+static void executeCommand(cc_VirtualTerminal* terminal);
+
+// For executeControlSequence, parameter with its default value if not given or 0
+static cc_type getParameter(const cc_VirtualTerminal* terminal, unsigned int index, cc_type defaultValue);
+
+// For parseByte, write a character at the cursor position
+static void printCharacter(cc_VirtualTerminal* terminal, uint32_t codepoint);
+
+// For the interpreted sequences, move the cursor down, scrolling at the bottom of the scrolling region
+static void lineFeed(cc_VirtualTerminal* terminal);
+
+// For the interpreted sequences, move the cursor up, scrolling at the top of the scrolling region
+static void reverseLineFeed(cc_VirtualTerminal* terminal);
+
+// For the interpreted sequences, move lines up (positive n) or down (negative n) between top and bottom
+static void scrollLines(cc_VirtualTerminal* terminal, cc_type top, cc_type bottom, cc_type n);
+
+// For the interpreted sequences, fill cells of a line with the erased cell
+static void eraseCells(cc_VirtualTerminal* terminal, cc_type y, cc_type fromX, cc_type toX);
+
+// For the interpreted sequences, set the cursor position in the terminal
+static void moveCursor(cc_VirtualTerminal* terminal, cc_type x, cc_type y);
+
+// For executeEscape, executeControlSequence and setMode
+static void saveCursor(cc_VirtualTerminal* terminal, SavedCursor* saved);
+
+// For executeEscape, executeControlSequence and setMode
+static void restoreCursor(cc_VirtualTerminal* terminal, const SavedCursor* saved);
+
+// For cc_createVirtualTerminal and executeEscape, initial state of the terminal
+static void resetTerminal(cc_VirtualTerminal* terminal);
+
+// For cc_virtualTerminalInput, cc_virtualTerminalSync and the replies to the requests, write all the bytes
+static bool writeAll(int fd, const char* bytes, size_t length);
+
+void* readOutputs(void* data) {
+	cc_VirtualTerminal* terminal = data;
+	unsigned char buffer[4096];
+	for(;;) {
+		ssize_t n = read(terminal->master, buffer, sizeof(buffer));
+		if(n == -1 && errno == EINTR) {
+			continue;
+		}
+		if(n <= 0) {
+			/* EIO once the slave is closed */
+			break;
+		}
+		pthread_mutex_lock(&terminal->mutex);
+		terminal->received += (unsigned long long) n;
+		for(ssize_t i = 0; i < n; ++i) {
+			parseByte(terminal, buffer[i]);
+		}
+		pthread_mutex_unlock(&terminal->mutex);
+	}
+
+	pthread_mutex_lock(&terminal->mutex);
+	terminal->closed = true;
+	pthread_cond_broadcast(&terminal->synchronized);
+	pthread_mutex_unlock(&terminal->mutex);
+	return NULL;
+}
+
+void parseByte(cc_VirtualTerminal* terminal, unsigned char byte) {
+	if(terminal->state == STRING_STATE || terminal->state == STRING_ESCAPE_STATE) {
+		if(terminal->state == STRING_ESCAPE_STATE) {
+			terminal->state = STRING_STATE;
+			if(byte == '\\') {
+				/* String terminator */
+				executeCommand(terminal);
+				terminal->state = GROUND_STATE;
+				return;
+			}
+			/* Other escape sequence, the string is aborted */
+			terminal->state = ESCAPE_STATE;
+			executeEscape(terminal, byte);
+			return;
+		}
+		if(byte == 0x07) {
+			/* BEL terminator */
+			executeCommand(terminal);
+			terminal->state = GROUND_STATE;
+		}
+		else if(byte == 0x1B) {
+			terminal->state = STRING_ESCAPE_STATE;
+		}
+		else if(terminal->command && terminal->commandLength < sizeof(terminal->commandString) - 1) {
+			terminal->commandString[terminal->commandLength++] = (char) byte;
+		}
+		return;
+	}
+
+	if(terminal->codepointBytes > 0) {
+		if((byte & 0xC0) == 0x80) {
+			terminal->codepoint = terminal->codepoint << 6 | (byte & 0x3Fu);
+			if(--terminal->codepointBytes == 0) {
+				printCharacter(terminal, terminal->codepoint);
+			}
+			return;
+		}
+		/* Truncated character */
+		terminal->codepointBytes = 0;
+		printCharacter(terminal, 0xFFFD);
+	}
+
+	if(byte == 0x1B) {
+		terminal->state = ESCAPE_STATE;
+		terminal->intermediate = 0;
+		return;
+	}
+	if(byte == 0x18 || byte == 0x1A) {
+		/* CAN and SUB cancel the sequence */
+		terminal->state = GROUND_STATE;
+		return;
+	}
+	if(byte < 0x20 || byte == 0x7F) {
+		/* Control characters are executed in the sequences too */
+		executeControl(terminal, byte);
+		return;
+	}
+
+	switch(terminal->state) {
+		case GROUND_STATE:
+			if(byte < 0x80) {
+				printCharacter(terminal, byte);
+			}
+			else if((byte & 0xE0) == 0xC0) {
+				terminal->codepoint = byte & 0x1Fu;
+				terminal->codepointBytes = 1;
+			}
+			else if((byte & 0xF0) == 0xE0) {
+				terminal->codepoint = byte & 0x0Fu;
+				terminal->codepointBytes = 2;
+			}
+			else if((byte & 0xF8) == 0xF0) {
+				terminal->codepoint = byte & 0x07u;
+				terminal->codepointBytes = 3;
+			}
+			else {
+				printCharacter(terminal, 0xFFFD);
+			}
+			break;
+		case ESCAPE_STATE:
+			executeEscape(terminal, byte);
+			break;
+		case ESCAPE_INTERMEDIATE_STATE:
+			if(byte >= 0x30) {
+				terminal->state = GROUND_STATE;
+			}
+			break;
+		case CSI_STATE:
+			if(byte >= '0' && byte <= '9') {
+				if(terminal->parametersNumber == 0) {
+					terminal->parametersNumber = 1;
+				}
+				unsigned int* parameter = &terminal->parameters[terminal->parametersNumber - 1];
+				if(*parameter < 10000) {
+					*parameter = *parameter * 10 + (unsigned int) (byte - '0');
+				}
+			}
+			else if(byte == ';') {
+				if(terminal->parametersNumber == 0) {
+					terminal->parametersNumber = 1;
+				}
+				if(terminal->parametersNumber < MAX_PARAMETERS) {
+					terminal->parameters[terminal->parametersNumber++] = 0;
+				}
+			}
+			else if(byte >= '<' && byte <= '?') {
+				terminal->privateMarker = (char) byte;
+			}
+			else if(byte < 0x30) {
+				terminal->intermediate = (char) byte;
+			}
+			else if(byte >= 0x40) {
+				executeControlSequence(terminal, byte);
+				terminal->state = GROUND_STATE;
+			}
+			break;
+		case STRING_STATE:
+			/* FALLTHROUGH */
+		case STRING_ESCAPE_STATE:
+			/* FALLTHROUGH */
+		default:
+			break;
+	}
+}
+
+void executeControl(cc_VirtualTerminal* terminal, unsigned char byte) {
+	switch(byte) {
+		case '\r':
+			terminal->cursor.x = 0;
+			terminal->wrapPending = false;
+			break;
+		case '\n':
+			/* FALLTHROUGH */
+		case '\v':
+			/* FALLTHROUGH */
+		case '\f':
+			lineFeed(terminal);
+			break;
+		case '\b':
+			moveCursor(terminal, terminal->cursor.x - 1, terminal->cursor.y);
+			break;
+		case '\t':
+			moveCursor(terminal, (terminal->cursor.x / 8 + 1) * 8, terminal->cursor.y);
+			break;
+		default:
+			/* Bell and others, nothing displayed */
+			break;
+	}
+}
+
+void executeEscape(cc_VirtualTerminal* terminal, unsigned char byte) {
+	terminal->state = GROUND_STATE;
+	switch(byte) {
+		case '[':
+			terminal->state = CSI_STATE;
+			terminal->parametersNumber = 0;
+			memset(terminal->parameters, 0, sizeof(terminal->parameters));
+			terminal->privateMarker = 0;
+			terminal->intermediate = 0;
+			break;
+		case ']':
+			/* FALLTHROUGH */
+		case 'P':
+			/* FALLTHROUGH */
+		case 'X':
+			/* FALLTHROUGH */
+		case '^':
+			/* FALLTHROUGH */
+		case '_':
+			terminal->state = STRING_STATE;
+			terminal->command = byte == '_';
+			terminal->commandLength = 0;
+			break;
+		case '7':
+			saveCursor(terminal, &terminal->savedCursor);
+			break;
+		case '8':
+			restoreCursor(terminal, &terminal->savedCursor);
+			break;
+		case 'D':
+			lineFeed(terminal);
+			break;
+		case 'E':
+			lineFeed(terminal);
+			terminal->cursor.x = 0;
+			break;
+		case 'M':
+			reverseLineFeed(terminal);
+			break;
+		case 'c':
+			resetTerminal(terminal);
+			break;
+		default:
+			if(byte < 0x30) {
+				terminal->state = ESCAPE_INTERMEDIATE_STATE;
+			}
+			break;
+	}
+}
+
+void executeControlSequence(cc_VirtualTerminal* terminal, unsigned char final) {
+	if(terminal->intermediate != 0) {
+		/* Replied to the mode requests, the library detects the synchronized output with them */
+		if(terminal->intermediate == '$' && terminal->privateMarker == '?' && final == 'p') {
+			reportMode(terminal);
+		}
+		/* Other requests and settings not displayed */
+		return;
+	}
+	if(terminal->privateMarker == '?') {
+		if(final == 'h' || final == 'l') {
+			setMode(terminal, final == 'h');
+		}
+		return;
+	}
+	if(terminal->privateMarker != 0) {
+		return;
+	}
+
+	cc_type x = terminal->cursor.x;
+	cc_type y = terminal->cursor.y;
+	cc_type n = getParameter(terminal, 0, 1);
+	switch(final) {
+		case 'A':
+			moveCursor(terminal, x, y - n);
+			break;
+		case 'B':
+			moveCursor(terminal, x, y + n);
+			break;
+		case 'C':
+			moveCursor(terminal, x + n, y);
+			break;
+		case 'D':
+			moveCursor(terminal, x - n, y);
+			break;
+		case 'E':
+			moveCursor(terminal, 0, y + n);
+			break;
+		case 'F':
+			moveCursor(terminal, 0, y - n);
+			break;
+		case 'G':
+			moveCursor(terminal, n - 1, y);
+			break;
+		case 'd':
+			moveCursor(terminal, x, n - 1);
+			break;
+		case 'H':
+			/* FALLTHROUGH */
+		case 'f':
+			moveCursor(terminal, getParameter(terminal, 1, 1) - 1, n - 1);
+			break;
+		case 'J':
+			switch(getParameter(terminal, 0, 0)) {
+				case 0:
+					eraseCells(terminal, y, x, terminal->width - 1);
+					for(cc_type line = y + 1; line < terminal->height; ++line) {
+						eraseCells(terminal, line, 0, terminal->width - 1);
+					}
+					break;
+				case 1:
+					for(cc_type line = 0; line < y; ++line) {
+						eraseCells(terminal, line, 0, terminal->width - 1);
+					}
+					eraseCells(terminal, y, 0, x);
+					break;
+				case 2:
+					for(cc_type line = 0; line < terminal->height; ++line) {
+						eraseCells(terminal, line, 0, terminal->width - 1);
+					}
+					break;
+				default:
+					/* No scrollback to erase */
+					break;
+			}
+			break;
+		case 'K':
+			switch(getParameter(terminal, 0, 0)) {
+				case 0:
+					eraseCells(terminal, y, x, terminal->width - 1);
+					break;
+				case 1:
+					eraseCells(terminal, y, 0, x);
+					break;
+				case 2:
+					eraseCells(terminal, y, 0, terminal->width - 1);
+					break;
+				default:
+					break;
+			}
+			break;
+		case 'X':
+			eraseCells(terminal, y, x, x + n - 1);
+			break;
+		case '@':
+			/* FALLTHROUGH */
+		case 'P': {
+			cc_PackedCell* line = &terminal->cells[(size_t) y * (size_t) terminal->width];
+			if(n > terminal->width - x) {
+				n = terminal->width - x;
+			}
+			size_t moved = (size_t) (terminal->width - x - n);
+			if(final == '@') {
+				memmove(&line[x + n], &line[x], moved * sizeof(cc_PackedCell));
+				eraseCells(terminal, y, x, x + n - 1);
+			}
+			else {
+				memmove(&line[x], &line[x + n], moved * sizeof(cc_PackedCell));
+				eraseCells(terminal, y, terminal->width - n, terminal->width - 1);
+			}
+			terminal->wrapPending = false;
+			break;
+		}
+		case 'L':
+			/* FALLTHROUGH */
+		case 'M':
+			if(y >= terminal->scrollTop && y <= terminal->scrollBottom) {
+				scrollLines(terminal, y, terminal->scrollBottom, final == 'L' ? -n : n);
+				moveCursor(terminal, 0, y);
+			}
+			break;
+		case 'S':
+			scrollLines(terminal, terminal->scrollTop, terminal->scrollBottom, n);
+			break;
+		case 'T':
+			scrollLines(terminal, terminal->scrollTop, terminal->scrollBottom, -n);
+			break;
+		case 'r': {
+			cc_type top = getParameter(terminal, 0, 1) - 1;
+			cc_type bottom = getParameter(terminal, 1, terminal->height) - 1;
+			if(bottom >= terminal->height) {
+				bottom = terminal->height - 1;
+			}
+			if(top < bottom) {
+				terminal->scrollTop = top;
+				terminal->scrollBottom = bottom;
+				moveCursor(terminal, 0, 0);
+			}
+			break;
+		}
+		case 's':
+			saveCursor(terminal, &terminal->savedCursor);
+			break;
+		case 'c':
+			if(getParameter(terminal, 0, 0) == 0) {
+				/* Primary device attributes: VT220 with ANSI colors */
+				writeAll(terminal->master, "\033[?62;22c", strlen("\033[?62;22c"));
+			}
+			break;
+		case 'u':
+			restoreCursor(terminal, &terminal->savedCursor);
+			break;
+		case 'm':
+			setGraphicRendition(terminal);
+			break;
+		default:
+			/* Not interpreted */
+			break;
+	}
+}
+
+void setGraphicRendition(cc_VirtualTerminal* terminal) {
+	/* Colors in the SGR order (black, red, green, yellow, blue, magenta, cyan, white) */
+	static const cc_Color colors[] = {BLACK, RED, GREEN, YELLOW, BLUE, MAGENTA, CYAN, WHITE,
+	                                  LIGHT_BLACK, LIGHT_RED, LIGHT_GREEN, LIGHT_YELLOW,
+	                                  LIGHT_BLUE, LIGHT_MAGENTA, LIGHT_CYAN, LIGHT_WHITE};
+
+	unsigned int parametersNumber = terminal->parametersNumber > 0 ? terminal->parametersNumber : 1;
+	for(unsigned int i = 0; i < parametersNumber; ++i) {
+		unsigned int value = terminal->parameters[i];
+		if(value == 0) {
+			terminal->backgroundColor = BLACK;
+			terminal->foregroundColor = WHITE;
+			terminal->attributes = NO_ATTRIBUTE;
+		}
+		else if(value == 1) {
+			terminal->attributes |= BOLD_ATTRIBUTE;
+		}
+		else if(value == 22) {
+			terminal->attributes &= ~(unsigned int) BOLD_ATTRIBUTE;
+		}
+		else if(value == 4) {
+			terminal->attributes |= UNDERLINE_ATTRIBUTE;
+		}
+		else if(value == 24) {
+			terminal->attributes &= ~(unsigned int) UNDERLINE_ATTRIBUTE;
+		}
+		else if(value == 7) {
+			terminal->attributes |= REVERSE_ATTRIBUTE;
+		}
+		else if(value == 27) {
+			terminal->attributes &= ~(unsigned int) REVERSE_ATTRIBUTE;
+		}
+		else if(value >= 30 && value <= 37) {
+			terminal->foregroundColor = colors[value - 30];
+		}
+		else if(value == 39) {
+			terminal->foregroundColor = WHITE;
+		}
+		else if(value >= 40 && value <= 47) {
+			terminal->backgroundColor = colors[value - 40];
+		}
+		else if(value == 49) {
+			terminal->backgroundColor = BLACK;
+		}
+		else if(value >= 90 && value <= 97) {
+			terminal->foregroundColor = colors[value - 90 + 8];
+		}
+		else if(value >= 100 && value <= 107) {
+			terminal->backgroundColor = colors[value - 100 + 8];
+		}
+		else if((value == 38 || value == 48) && i + 1 < parametersNumber) {
+			/* Indexed or direct colors not displayed, their values are skipped */
+			i += terminal->parameters[i + 1] == 5 ? 2 : 4;
+		}
+	}
+}
+
+void setMode(cc_VirtualTerminal* terminal, bool enabled) {
+	for(unsigned int i = 0; i < terminal->parametersNumber; ++i) {
+		if(terminal->parameters[i] == 2026) {
+			terminal->synchronizedUpdate = enabled;
+			continue;
+		}
+		if(terminal->parameters[i] != 1049 || enabled == terminal->alternateScreen) {
+			/* Cursor visibility... not displayed */
+			continue;
+		}
+
+		cc_PackedCell* cells = terminal->cells;
+		terminal->cells = terminal->otherCells;
+		terminal->otherCells = cells;
+		terminal->alternateScreen = enabled;
+		if(enabled) {
+			saveCursor(terminal, &terminal->alternateSavedCursor);
+			for(cc_type y = 0; y < terminal->height; ++y) {
+				eraseCells(terminal, y, 0, terminal->width - 1);
+			}
+		}
+		else {
+			restoreCursor(terminal, &terminal->alternateSavedCursor);
+		}
+	}
+}
+
+void reportMode(cc_VirtualTerminal* terminal) {
+	/* Mode state: 1 set, 2 reset, 0 not recognized */
+	unsigned int mode = terminal->parametersNumber > 0 ? terminal->parameters[0] : 0;
+	unsigned int state = 0;
+	if(mode == 1049) {
+		state = terminal->alternateScreen ? 1 : 2;
+	}
+	else if(mode == 2026) {
+		state = terminal->synchronizedUpdate ? 1 : 2;
+	}
+
+	char reply[32];
+	int length = snprintf(reply, sizeof(reply), "\033[?%u;%u$y", mode, state);
+	writeAll(terminal->master, reply, (size_t) length);
+}
+
+void executeCommand(cc_VirtualTerminal* terminal) {
+	if(!terminal->command) {
+		return;
+	}
+	terminal->commandString[terminal->commandLength] = '\0';
+	if(strncmp(terminal->commandString, SYNC_COMMAND, strlen(SYNC_COMMAND)) == 0) {
+		/* Written by cc_virtualTerminalSync, not an output of the context */
+		terminal->syncReceived = (unsigned int) strtoul(&terminal->commandString[strlen(SYNC_COMMAND)], NULL, 10);
+		terminal->received -= terminal->commandLength + 4;
+		pthread_cond_broadcast(&terminal->synchronized);
+	}
+}
+
+cc_type getParameter(const cc_VirtualTerminal* terminal, unsigned int index, cc_type defaultValue) {
+	if(index >= terminal->parametersNumber || terminal->parameters[index] == 0) {
+		return defaultValue;
+	}
+	return (cc_type) terminal->parameters[index];
+}
+
+void printCharacter(cc_VirtualTerminal* terminal, uint32_t codepoint) {
+	if(terminal->wrapPending) {
+		terminal->cursor.x = 0;
+		lineFeed(terminal);
+	}
+	terminal->cells[(size_t) terminal->cursor.y * (size_t) terminal->width + (size_t) terminal->cursor.x] =
+		cc_packCell(codepoint, terminal->backgroundColor, terminal->foregroundColor, terminal->attributes);
+	if(terminal->cursor.x == terminal->width - 1) {
+		terminal->wrapPending = true;
+	}
+	else {
+		++terminal->cursor.x;
+	}
+}
+
+void lineFeed(cc_VirtualTerminal* terminal) {
+	terminal->wrapPending = false;
+	if(terminal->cursor.y == terminal->scrollBottom) {
+		scrollLines(terminal, terminal->scrollTop, terminal->scrollBottom, 1);
+	}
+	else if(terminal->cursor.y < terminal->height - 1) {
+		++terminal->cursor.y;
+	}
+}
+
+void reverseLineFeed(cc_VirtualTerminal* terminal) {
+	terminal->wrapPending = false;
+	if(terminal->cursor.y == terminal->scrollTop) {
+		scrollLines(terminal, terminal->scrollTop, terminal->scrollBottom, -1);
+	}
+	else if(terminal->cursor.y > 0) {
+		--terminal->cursor.y;
+	}
+}
+
+void scrollLines(cc_VirtualTerminal* terminal, cc_type top, cc_type bottom, cc_type n) {
+	cc_type rows = bottom - top + 1;
+	cc_type shift = n < 0 ? -n : n;
+	if(shift > rows) {
+		shift = rows;
+	}
+	size_t width = (size_t) terminal->width;
+	size_t moved = (size_t) (rows - shift) * width * sizeof(cc_PackedCell);
+	cc_PackedCell* topLine = &terminal->cells[(size_t) top * width];
+	if(n > 0) {
+		memmove(topLine, &topLine[(size_t) shift * width], moved);
+		for(cc_type y = bottom - shift + 1; y <= bottom; ++y) {
+			eraseCells(terminal, y, 0, terminal->width - 1);
+		}
+	}
+	else {
+		memmove(&topLine[(size_t) shift * width], topLine, moved);
+		for(cc_type y = top; y < top + shift; ++y) {
+			eraseCells(terminal, y, 0, terminal->width - 1);
+		}
+	}
+}
+
+void eraseCells(cc_VirtualTerminal* terminal, cc_type y, cc_type fromX, cc_type toX) {
+	/* Erased with the current colors, as most consoles do */
+	cc_PackedCell erased = cc_packCell(' ', terminal->backgroundColor, terminal->foregroundColor, NO_ATTRIBUTE);
+	if(toX >= terminal->width) {
+		toX = terminal->width - 1;
+	}
+	cc_PackedCell* line = &terminal->cells[(size_t) y * (size_t) terminal->width];
+	for(cc_type x = fromX < 0 ? 0 : fromX; x <= toX; ++x) {
+		line[x] = erased;
+	}
+	terminal->wrapPending = false;
+}
+
+void moveCursor(cc_VirtualTerminal* terminal, cc_type x, cc_type y) {
+	terminal->cursor.x = x < 0 ? 0 : (x < terminal->width ? x : terminal->width - 1);
+	terminal->cursor.y = y < 0 ? 0 : (y < terminal->height ? y : terminal->height - 1);
+	terminal->wrapPending = false;
+}
+
+void saveCursor(cc_VirtualTerminal* terminal, SavedCursor* saved) {
+	saved->position = terminal->cursor;
+	saved->backgroundColor = terminal->backgroundColor;
+	saved->foregroundColor = terminal->foregroundColor;
+	saved->attributes = terminal->attributes;
+}
+
+void restoreCursor(cc_VirtualTerminal* terminal, const SavedCursor* saved) {
+	moveCursor(terminal, saved->position.x, saved->position.y);
+	terminal->backgroundColor = saved->backgroundColor;
+	terminal->foregroundColor = saved->foregroundColor;
+	terminal->attributes = saved->attributes;
+}
+
+void resetTerminal(cc_VirtualTerminal* terminal) {
+	if(terminal->alternateScreen) {
+		cc_PackedCell* cells = terminal->cells;
+		terminal->cells = terminal->otherCells;
+		terminal->otherCells = cells;
+		terminal->alternateScreen = false;
+	}
+	terminal->backgroundColor = BLACK;
+	terminal->foregroundColor = WHITE;
+	terminal->attributes = NO_ATTRIBUTE;
+	terminal->synchronizedUpdate = false;
+	terminal->scrollTop = 0;
+	terminal->scrollBottom = terminal->height - 1;
+	for(cc_type y = 0; y < terminal->height; ++y) {
+		eraseCells(terminal, y, 0, terminal->width - 1);
+	}
+	moveCursor(terminal, 0, 0);
+	saveCursor(terminal, &terminal->savedCursor);
+	saveCursor(terminal, &terminal->alternateSavedCursor);
+}
+
+bool writeAll(int fd, const char* bytes, size_t length) {
+	while(length > 0) {
+		ssize_t n = write(fd, bytes, length);
+		if(n == -1 && errno == EINTR) {
+			continue;
+		}
+		if(n == -1 && errno == EAGAIN) {
+			/* Non-blocking output of the context, the file status is shared */
+			struct pollfd pfd = {fd, POLLOUT, 0};
+			poll(&pfd, 1, -1);
+			continue;
+		}
+		if(n <= 0) {
+			LOG_ERROR("write failed (%s)", strerror(errno));
+			return false;
+		}
+		bytes += n;
+		length -= (size_t) n;
+	}
+	return true;
+}
+
+cc_VirtualTerminal* cc_createVirtualTerminal(cc_type width, cc_type height) {
+	if(width <= 0 || height <= 0 || width > USHRT_MAX || height > USHRT_MAX) {
+		LOG_ERROR("Invalid virtual terminal size");
+		return NULL;
+	}
+
+	cc_VirtualTerminal* terminal = calloc(1, sizeof(cc_VirtualTerminal));
+	if(terminal == NULL) {
+		LOG_ERROR("calloc failed");
+		return NULL;
+	}
+	terminal->width = width;
+	terminal->height = height;
+	terminal->cells = malloc((size_t) width * (size_t) height * sizeof(cc_PackedCell));
+	terminal->otherCells = malloc((size_t) width * (size_t) height * sizeof(cc_PackedCell));
+	if(terminal->cells == NULL || terminal->otherCells == NULL) {
+		LOG_ERROR("malloc failed");
+		free(terminal->cells);
+		free(terminal->otherCells);
+		free(terminal);
+		return NULL;
+	}
+	resetTerminal(terminal);
+	memcpy(terminal->otherCells, terminal->cells, (size_t) width * (size_t) height * sizeof(cc_PackedCell));
+
+	/* Pseudo-terminal, the context uses the slave */
+	errno = 0;
+	terminal->master = posix_openpt(O_RDWR | O_NOCTTY);
+	const char* slaveName = NULL;
+	if(terminal->master == -1
+	   || grantpt(terminal->master) == -1
+	   || unlockpt(terminal->master) == -1
+	   || (slaveName = ptsname(terminal->master)) == NULL
+	   || (terminal->slave = open(slaveName, O_RDWR | O_NOCTTY)) == -1) {
+		LOG_ERROR("pseudo-terminal opening failed (%s)", strerror(errno));
+		if(terminal->master != -1) {
+			close(terminal->master);
+		}
+		free(terminal->cells);
+		free(terminal->otherCells);
+		free(terminal);
+		return NULL;
+	}
+
+	/* Raw inputs without echo, the outputs new lines converted */
+	struct termios mode;
+	errno = 0;
+	if(tcgetattr(terminal->slave, &mode) == 0) {
+		mode.c_iflag &= ~((tcflag_t) (IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON));
+		mode.c_lflag &= ~((tcflag_t) (ECHO | ECHONL | ICANON | ISIG | IEXTEN));
+		mode.c_cc[VMIN] = 1;
+		mode.c_cc[VTIME] = 0;
+		errno = 0;
+		if(tcsetattr(terminal->slave, TCSANOW, &mode)) {
+			LOG_ERROR("tcsetattr failed (%s)", strerror(errno));
+		}
+	}
+	else {
+		LOG_ERROR("tcgetattr failed (%s)", strerror(errno));
+	}
+	struct winsize size = {(unsigned short) height, (unsigned short) width, 0, 0};
+	if(ioctl(terminal->master, TIOCSWINSZ, &size) == -1) {
+		LOG_ERROR("ioctl failed (%s)", strerror(errno));
+	}
+
+	terminal->context = cc_createContext(terminal->slave, terminal->slave);
+	if(terminal->context == NULL) {
+		close(terminal->slave);
+		close(terminal->master);
+		free(terminal->cells);
+		free(terminal->otherCells);
+		free(terminal);
+		return NULL;
+	}
+
+	int error = pthread_mutex_init(&terminal->mutex, NULL);
+	if(!error) {
+		error = pthread_cond_init(&terminal->synchronized, NULL);
+		if(!error) {
+			error = pthread_create(&terminal->thread, NULL, readOutputs, terminal);
+			if(error) {
+				pthread_cond_destroy(&terminal->synchronized);
+			}
+		}
+		if(error) {
+			pthread_mutex_destroy(&terminal->mutex);
+		}
+	}
+	if(error) {
+		LOG_ERROR("virtual terminal thread creation failed (%s)", strerror(error));
+		cc_destroyContext(terminal->context);
+		close(terminal->slave);
+		close(terminal->master);
+		free(terminal->cells);
+		free(terminal->otherCells);
+		free(terminal);
+		return NULL;
+	}
+
+	return terminal;
+}
+
+void cc_destroyVirtualTerminal(cc_VirtualTerminal* terminal) {
+	if(terminal == NULL) {
+		return;
+	}
+
+	/* The thread reads the remaining outputs and stops once the slave is closed */
+	cc_destroyContext(terminal->context);
+	close(terminal->slave);
+	pthread_join(terminal->thread, NULL);
+	close(terminal->master);
+
+	pthread_cond_destroy(&terminal->synchronized);
+	pthread_mutex_destroy(&terminal->mutex);
+	free(terminal->cells);
+	free(terminal->otherCells);
+	free(terminal);
+}
+
+cc_Context* cc_virtualTerminalGetContext(const cc_VirtualTerminal* terminal) {
+	return terminal->context;
+}
+
+cc_type cc_getVirtualTerminalWidth(cc_VirtualTerminal* terminal) {
+	pthread_mutex_lock(&terminal->mutex);
+	cc_type width = terminal->width;
+	pthread_mutex_unlock(&terminal->mutex);
+	return width;
+}
+
+cc_type cc_getVirtualTerminalHeight(cc_VirtualTerminal* terminal) {
+	pthread_mutex_lock(&terminal->mutex);
+	cc_type height = terminal->height;
+	pthread_mutex_unlock(&terminal->mutex);
+	return height;
+}
+
+bool cc_virtualTerminalResize(cc_VirtualTerminal* terminal, cc_type width, cc_type height) {
+	if(width <= 0 || height <= 0 || width > USHRT_MAX || height > USHRT_MAX) {
+		LOG_ERROR("Invalid virtual terminal size");
+		return false;
+	}
+
+	size_t cellsNumber = (size_t) width * (size_t) height;
+	cc_PackedCell* cells = malloc(cellsNumber * sizeof(cc_PackedCell));
+	cc_PackedCell* otherCells = malloc(cellsNumber * sizeof(cc_PackedCell));
+	if(cells == NULL || otherCells == NULL) {
+		LOG_ERROR("malloc failed");
+		free(cells);
+		free(otherCells);
+		return false;
+	}
+
+	pthread_mutex_lock(&terminal->mutex);
+	cc_PackedCell blank = cc_packCell(' ', BLACK, WHITE, NO_ATTRIBUTE);
+	for(size_t i = 0; i < cellsNumber; ++i) {
+		cells[i] = blank;
+		otherCells[i] = blank;
+	}
+	cc_type keptWidth = width < terminal->width ? width : terminal->width;
+	cc_type keptHeight = height < terminal->height ? height : terminal->height;
+	for(cc_type y = 0; y < keptHeight; ++y) {
+		memcpy(&cells[(size_t) y * (size_t) width],
+		       &terminal->cells[(size_t) y * (size_t) terminal->width],
+		       (size_t) keptWidth * sizeof(cc_PackedCell));
+		memcpy(&otherCells[(size_t) y * (size_t) width],
+		       &terminal->otherCells[(size_t) y * (size_t) terminal->width],
+		       (size_t) keptWidth * sizeof(cc_PackedCell));
+	}
+	free(terminal->cells);
+	free(terminal->otherCells);
+	terminal->cells = cells;
+	terminal->otherCells = otherCells;
+	terminal->width = width;
+	terminal->height = height;
+	terminal->scrollTop = 0;
+	terminal->scrollBottom = height - 1;
+	moveCursor(terminal, terminal->cursor.x, terminal->cursor.y);
+	pthread_mutex_unlock(&terminal->mutex);
+
+	struct winsize size = {(unsigned short) height, (unsigned short) width, 0, 0};
+	if(ioctl(terminal->master, TIOCSWINSZ, &size) == -1) {
+		LOG_ERROR("ioctl failed (%s)", strerror(errno));
+	}
+	cc_contextInvalidateSize(terminal->context);
+	return true;
+}
+
+bool cc_virtualTerminalInput(cc_VirtualTerminal* terminal, const char* bytes, size_t length) {
+	return writeAll(terminal->master, bytes, length);
+}
+
+bool cc_virtualTerminalInputKey(cc_VirtualTerminal* terminal, cc_Key key) {
+	/* Sequences sent by xterm-like consoles, recognized by cc_getInput */
+	const char* sequence;
+	switch(key) {
+		case HOME_KEY:
+			sequence = "\033[H";
+			break;
+		case END_KEY:
+			sequence = "\033[F";
+			break;
+		case PAGE_UP_KEY:
+			sequence = "\033[5~";
+			break;
+		case PAGE_DOWN_KEY:
+			sequence = "\033[6~";
+			break;
+		case UP_ARROW_KEY:
+			sequence = "\033[A";
+			break;
+		case DOWN_ARROW_KEY:
+			sequence = "\033[B";
+			break;
+		case LEFT_ARROW_KEY:
+			sequence = "\033[D";
+			break;
+		case RIGHT_ARROW_KEY:
+			sequence = "\033[C";
+			break;
+		case BACKSPACE_KEY:
+			sequence = "\b";
+			break;
+		case TAB_KEY:
+			sequence = "\t";
+			break;
+		case ENTER_KEY:
+			sequence = "\n";
+			break;
+		case ESC_KEY:
+			sequence = "\033";
+			break;
+		case SPACE_KEY:
+			sequence = " ";
+			break;
+		case INS_KEY:
+			sequence = "\033[2~";
+			break;
+		case DEL_KEY:
+			sequence = "\033[3~";
+			break;
+		case F1_KEY:
+			sequence = "\033OP";
+			break;
+		case F2_KEY:
+			sequence = "\033OQ";
+			break;
+		case F3_KEY:
+			sequence = "\033OR";
+			break;
+		case F4_KEY:
+			sequence = "\033OS";
+			break;
+		case F5_KEY:
+			sequence = "\033[15~";
+			break;
+		case F6_KEY:
+			sequence = "\033[17~";
+			break;
+		case F7_KEY:
+			sequence = "\033[18~";
+			break;
+		case F8_KEY:
+			sequence = "\033[19~";
+			break;
+		case F9_KEY:
+			sequence = "\033[20~";
+			break;
+		case F10_KEY:
+			sequence = "\033[21~";
+			break;
+		case F11_KEY:
+			sequence = "\033[23~";
+			break;
+		case F12_KEY:
+			sequence = "\033[24~";
+			break;
+		case OTHER_KEY:
+			/* FALLTHROUGH */
+		default:
+			LOG_ERROR("Invalid key");
+			return false;
+	}
+	return writeAll(terminal->master, sequence, strlen(sequence));
+}
+
+bool cc_virtualTerminalSync(cc_VirtualTerminal* terminal) {
+	/* In non-blocking output mode the queued outputs are written while the thread reads them */
+	while(cc_contextFlushOutput(terminal->context) > 0) {
+		struct pollfd pfd = {terminal->slave, POLLOUT, 0};
+		poll(&pfd, 1, -1);
+	}
+
+	/* Command written after the outputs, received once they are interpreted */
+	char command[32];
+	unsigned int sync = ++terminal->syncRequested;
+	int length = snprintf(command, sizeof(command), "\033_" SYNC_COMMAND "%u\033\\", sync);
+	if(!writeAll(terminal->slave, command, (size_t) length)) {
+		return false;
+	}
+
+	pthread_mutex_lock(&terminal->mutex);
+	while(terminal->syncReceived != sync && !terminal->closed) {
+		pthread_cond_wait(&terminal->synchronized, &terminal->mutex);
+	}
+	bool synchronized = terminal->syncReceived == sync;
+	pthread_mutex_unlock(&terminal->mutex);
+	return synchronized;
+}
+
+cc_PackedCell cc_virtualTerminalGetCell(cc_VirtualTerminal* terminal, cc_Vector2 position) {
+	cc_PackedCell cell = cc_packCell(' ', BLACK, WHITE, NO_ATTRIBUTE);
+	pthread_mutex_lock(&terminal->mutex);
+	if(position.x >= 0 && position.x < terminal->width && position.y >= 0 && position.y < terminal->height) {
+		cell = terminal->cells[(size_t) position.y * (size_t) terminal->width + (size_t) position.x];
+	}
+	pthread_mutex_unlock(&terminal->mutex);
+	return cell;
+}
+
+size_t cc_virtualTerminalGetText(cc_VirtualTerminal* terminal, cc_type y, char* buffer, size_t size) {
+	if(size == 0) {
+		return 0;
+	}
+
+	size_t length = 0;
+	pthread_mutex_lock(&terminal->mutex);
+	if(y >= 0 && y < terminal->height) {
+		const cc_PackedCell* line = &terminal->cells[(size_t) y * (size_t) terminal->width];
+		cc_type end = terminal->width;
+		while(end > 0 && cc_cellCodepoint(line[end - 1]) == ' ') {
+			--end;
+		}
+		for(cc_type x = 0; x < end; ++x) {
+			uint32_t codepoint = cc_cellCodepoint(line[x]);
+			char bytes[4];
+			size_t bytesNumber;
+			if(codepoint < 0x80) {
+				bytes[0] = (char) codepoint;
+				bytesNumber = 1;
+			}
+			else if(codepoint < 0x800) {
+				bytes[0] = (char) (0xC0 | codepoint >> 6);
+				bytes[1] = (char) (0x80 | (codepoint & 0x3F));
+				bytesNumber = 2;
+			}
+			else if(codepoint < 0x10000) {
+				bytes[0] = (char) (0xE0 | codepoint >> 12);
+				bytes[1] = (char) (0x80 | (codepoint >> 6 & 0x3F));
+				bytes[2] = (char) (0x80 | (codepoint & 0x3F));
+				bytesNumber = 3;
+			}
+			else {
+				bytes[0] = (char) (0xF0 | codepoint >> 18);
+				bytes[1] = (char) (0x80 | (codepoint >> 12 & 0x3F));
+				bytes[2] = (char) (0x80 | (codepoint >> 6 & 0x3F));
+				bytes[3] = (char) (0x80 | (codepoint & 0x3F));
+				bytesNumber = 4;
+			}
+			if(length + bytesNumber >= size) {
+				break;
+			}
+			memcpy(&buffer[length], bytes, bytesNumber);
+			length += bytesNumber;
+		}
+	}
+	pthread_mutex_unlock(&terminal->mutex);
+	buffer[length] = '\0';
+	return length;
+}
+
+cc_Vector2 cc_virtualTerminalGetCursorPosition(cc_VirtualTerminal* terminal) {
+	pthread_mutex_lock(&terminal->mutex);
+	cc_Vector2 position = terminal->cursor;
+	pthread_mutex_unlock(&terminal->mutex);
+	return position;
+}
+
+unsigned long long cc_virtualTerminalGetReceivedBytes(cc_VirtualTerminal* terminal) {
+	pthread_mutex_lock(&terminal->mutex);
+	unsigned long long received = terminal->received;
+	pthread_mutex_unlock(&terminal->mutex);
+	return received;
+}
+
+bool cc_virtualTerminalFindDifference(cc_VirtualTerminal* terminal, cc_VirtualTerminal* otherTerminal,
+                                      cc_Vector2* position) {
+	if(terminal == otherTerminal) {
+		return false;
+	}
+
+	cc_Vector2 difference = {0, 0};
+	bool different = false;
+	/* Locked in address order, a comparison of the same terminals in the other order cannot deadlock */
+	bool addressOrder = (uintptr_t) terminal < (uintptr_t) otherTerminal;
+	pthread_mutex_lock(addressOrder ? &terminal->mutex : &otherTerminal->mutex);
+	pthread_mutex_lock(addressOrder ? &otherTerminal->mutex : &terminal->mutex);
+	if(terminal->width != otherTerminal->width || terminal->height != otherTerminal->height) {
+		different = true;
+	}
+	else {
+		size_t cellsNumber = (size_t) terminal->width * (size_t) terminal->height;
+		for(size_t i = 0; i < cellsNumber; ++i) {
+			if(terminal->cells[i] != otherTerminal->cells[i]) {
+				difference.x = (cc_type) (i % (size_t) terminal->width);
+				difference.y = (cc_type) (i / (size_t) terminal->width);
+				different = true;
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&otherTerminal->mutex);
+	pthread_mutex_unlock(&terminal->mutex);
+
+	if(different && position != NULL) {
+		*position = difference;
+	}
+	return different;
+}
+
+#endif //OS_WINDOWS
@@ -29,7 +29,27 @@
 #ifndef OS_WINDOWS
 
 void cc_permanentReverseColors() {
-	printf(CSI SGR_REVERSE_VALUE SGR_CODE);
+	cc_contextPermanentReverseColors(cc_getCurrentContext());
+}
+
+void cc_contextPermanentReverseColors(cc_Context* context) {
+	fprintf(cc_contextGetOutput(context), CSI SGR_REVERSE_VALUE SGR_CODE);
+}
+
+void cc_setNonBlockingOutput(bool nonBlocking) {
+	cc_contextSetNonBlockingOutput(cc_getCurrentContext(), nonBlocking);
+}
+
+size_t cc_flushOutput() {
+	return cc_contextFlushOutput(cc_getCurrentContext());
+}
+
+size_t cc_outputPending() {
+	return cc_contextOutputPending(cc_getCurrentContext());
+}
+
+double cc_outputDrainRate() {
+	return cc_contextOutputDrainRate(cc_getCurrentContext());
 }
 
 #endif //OS_WINDOWS
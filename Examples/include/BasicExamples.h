@@ -43,6 +43,8 @@ void printRectangles();
 
 void printCircle();
 
+void printScrolling();
+
 void basicExamples();
 
 
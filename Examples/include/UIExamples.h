@@ -38,6 +38,8 @@ void optionMenuExamples();
 
 void messageExamples();
 
+void modalMessageExamples();
+
 void UIExamples();
 
 
@@ -486,6 +486,48 @@ void printCircle() {
 	}
 }
 
+void printScrolling() {
+	LOG_INFO("Print scrolling");
+
+	cc_displayInputs(false);
+	cc_setBackgroundColor(BLACK);
+	cc_clean();
+
+	cc_type top = 2;
+	cc_type bottom = cc_getHeight() - 3;
+	cc_Vector2 pos = {2, 0};
+	cc_setForegroundColor(WHITE);
+	cc_setCursorPosition(pos);
+	printf("Up/Down arrows: scroll, Escape: back");
+
+	/* Fill the pane once, then only the exposed line is drawn */
+	unsigned int first = 0;
+	for(pos.y = top; pos.y <= bottom; ++pos.y) {
+		cc_setCursorPosition(pos);
+		printf("Line %u", first + (unsigned int) (pos.y - top));
+	}
+
+	cc_Input input = cc_getInput();
+	while(input.key != ESC_KEY) {
+		if(input.key == DOWN_ARROW_KEY) {
+			++first;
+			cc_scrollRegion(top, bottom, 1);
+			pos.y = bottom;
+			cc_setCursorPosition(pos);
+			printf("Line %u", first + (unsigned int) (bottom - top));
+		}
+		else if(input.key == UP_ARROW_KEY && first) {
+			--first;
+			cc_scrollRegion(top, bottom, -1);
+			pos.y = top;
+			cc_setCursorPosition(pos);
+			printf("Line %u", first);
+		}
+		input = cc_getInput();
+	}
+	cc_resetScrollRegion();
+}
+
 void basicExamples() {
 
 	const char* choices[] = {
@@ -494,6 +536,7 @@ void basicExamples() {
 		"Print lines",
 		"Print rectangles",
 		"Print circle",
+		"Print scrolling",
 		"Back",
 	};
 	const cc_MenuColors colors = {
@@ -508,9 +551,9 @@ void basicExamples() {
 	cc_Menu menu;
 	menu.title = "Basic examples";
 	menu.choices = choices;
-	menu.choicesNumber = 6;
+	menu.choicesNumber = 7;
 	menu.currentChoice = 0;
-	menu.choiceOnEscape = 5;
+	menu.choiceOnEscape = 6;
 
 	LOG_INFO("Enter the basic examples menu");
 	bool loop = true;
@@ -540,6 +583,10 @@ void basicExamples() {
 				printCircle();
 				break;
 			case 5:
+				cc_clean();
+				printScrolling();
+				break;
+			case 6:
 				loop = false;
 				break;
 			default:
@@ -315,21 +315,67 @@ void messageExamples() {
 	}
 }
 
+void modalMessageExamples() {
+	LOG_INFO("Start modal message examples");
+
+	cc_Screen* screen = cc_createScreen(cc_getWidth(), cc_getHeight());
+	if(screen == NULL) {
+		return;
+	}
+	cc_type width = cc_getScreenWidth(screen);
+	cc_type height = cc_getScreenHeight(screen);
+
+	/* Draw a dashboard */
+	cc_Vector2 topLeft = {0, 0};
+	cc_Vector2 downRight = {width - 1, 0};
+	cc_Cell titleCell = {' ', CYAN, BLACK};
+	cc_screenFill(screen, topLeft, downRight, titleCell);
+	cc_screenPrint(screen, topLeft, " Dashboard", CYAN, BLACK);
+	char line[64];
+	cc_Vector2 pos = {1, 0};
+	for(pos.y = 2; pos.y < height; ++pos.y) {
+		snprintf(line, sizeof(line), "Value %d: %d", pos.y - 1, (pos.y * 7919) % 1000);
+		cc_screenPrint(screen, pos, line, BLACK, (cc_Color) (1 + pos.y % 6));
+	}
+
+	cc_Message message;
+	message.title = "Dashboard";
+	message.message = "Quit the dashboard?\n\n(only the area of this message\nis drawn again when it closes)";
+	message.leftChoice = "Yes";
+	message.middleChoice = NULL;
+	message.rightChoice = "No";
+	message.currentChoice = RIGHT_CHOICE;
+	message.canEscape = false;
+
+	cc_Vector2 counterPos = {width - 20, 0};
+	unsigned int closedCount = 0;
+	do {
+		snprintf(line, sizeof(line), "Closed %u times", closedCount++);
+		cc_screenPrint(screen, counterPos, line, CYAN, BLACK);
+		cc_screenFlush(screen);
+		cc_displayColorModalMessage(&message, &mcolors, screen);
+	} while(message.currentChoice != LEFT_CHOICE);
+
+	cc_destroyScreen(screen);
+	cc_setColors(BLACK, WHITE);
+}
+
 void UIExamples() {
 
 	const char* choices[] = {
 		"Menu examples",
 		"Options menus examples",
 		"Messages examples",
+		"Modal message example",
 		"Back",
 	};
 
 	cc_Menu menu;
 	menu.title = "UI examples";
 	menu.choices = choices;
-	menu.choicesNumber = 4;
+	menu.choicesNumber = 5;
 	menu.currentChoice = 0;
-	menu.choiceOnEscape = 3;
+	menu.choiceOnEscape = 4;
 
 	LOG_INFO("Enter the UI examples menu");
 	bool loop = true;
@@ -347,6 +393,9 @@ void UIExamples() {
 				messageExamples();
 				break;
 			case 3:
+				modalMessageExamples();
+				break;
+			case 4:
 				loop = false;
 				break;
 			default:
@@ -26,6 +26,8 @@ int main() {
 	}
 	lg_setOutputStream(fp);
 	LOG_INFO("ConsoleControl examples start");
+	cc_setSynchronizedOutput(true);
+	cc_enterAlternateScreen();
 
 	const char* choices[] = {
 		"Basic features",
@@ -61,6 +63,8 @@ int main() {
 	}
 	LOG_INFO("Exit the main menu");
 
+	cc_setColors(BLACK, WHITE);
+	cc_leaveAlternateScreen();
 	cc_setCursorVisibility(true);
 	cc_displayInputs(true);
 	LOG_INFO("ConsoleControl examples end");
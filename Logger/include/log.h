@@ -39,17 +39,73 @@ extern "C" {
 #define LOGGER_ENABLED 0
 #endif
 
-#define LOG_DEBUG(...) lg_log(__FILE__, __LINE__, __func__, DEBUG_LV, ## __VA_ARGS__)
-#define LOG_INFO(...) lg_log(__FILE__, __LINE__, __func__, INFO_LV, ## __VA_ARGS__)
-#define LOG_WARN(...) lg_log(__FILE__, __LINE__, __func__, WARN_LV, ## __VA_ARGS__)
-#define LOG_ERROR(...) lg_log(__FILE__, __LINE__, __func__, ERROR_LV, ## __VA_ARGS__)
-#define LOG_FATAL(...) lg_log(__FILE__, __LINE__, __func__, FATAL_LV, ## __VA_ARGS__)
+// Minimal level of the logs compiled: 0x1 (DEBUG_LV), 0x2 (INFO_LV), 0x4 (WARN_LV), 0x8 (ERROR_LV), 0x10 (FATAL_LV),
+// the logs of the lower levels are removed (arguments not evaluated), 0x20 removes all the logs
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0x1
+#endif
+
+#if LOGGER_MIN_LEVEL <= 0x1
+#define LOG_DEBUG(...) LOG_CALL_SITE(DEBUG_LV, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void) 0)
+#endif
+#if LOGGER_MIN_LEVEL <= 0x2
+#define LOG_INFO(...) LOG_CALL_SITE(INFO_LV, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void) 0)
+#endif
+#if LOGGER_MIN_LEVEL <= 0x4
+#define LOG_WARN(...) LOG_CALL_SITE(WARN_LV, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void) 0)
+#endif
+#if LOGGER_MIN_LEVEL <= 0x8
+#define LOG_ERROR(...) LOG_CALL_SITE(ERROR_LV, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void) 0)
+#endif
+#if LOGGER_MIN_LEVEL <= 0x10
+#define LOG_FATAL(...) LOG_CALL_SITE(FATAL_LV, __VA_ARGS__)
+#else
+#define LOG_FATAL(...) ((void) 0)
+#endif
+
+// Format of a log, first argument of the log macros
+#define LOG_FORMAT(format, ...) format
+
+// Log with a static call site, registered once in the binary log, the arguments are evaluated only if the level
+// is processed. The format must be a string literal, the format of the call site (a format computed at run time does
+// not compile in C, use lg_log for it)
+#define LOG_CALL_SITE(level, ...) do { \
+	if(LG_PROCESSED_LEVELS() & (level)) { \
+		static lg_CallSite lg_callSite = {__FILE__, __LINE__, __func__, level, LOG_FORMAT(__VA_ARGS__, ~), 0, 0, 0, 0, 0, 0, 0, 0, NULL}; \
+		lg_logCallSite(&lg_callSite, __VA_ARGS__); \
+	} \
+} while(0)
 
 #include <stdio.h>
 #include <time.h>
 #include <stdbool.h>
 #include <stdarg.h>
 
+#if defined(__cplusplus) && __cplusplus < 202302L
+// stdatomic.h is not available in C++ before C++23: the atomic members of the call sites are declared with the same
+// size and alignment and only accessed by the logger, the processed levels are read with lg_getProcessedLevels
+#define LG_ATOMIC_UINT unsigned int
+#define LG_PROCESSED_LEVELS() lg_getProcessedLevels()
+#else
+#include <stdatomic.h>
+#define LG_ATOMIC_UINT atomic_uint
+#define LG_PROCESSED_LEVELS() atomic_load_explicit(&lg_processedLevels, memory_order_relaxed)
+#endif
+
+// Size of the messages buffers in asynchronous mode, longer messages are truncated
+#define LOG_MESSAGE_SIZE 256
+
+// Default maximal number of logs per second of a call site
+#define LOG_DEFAULT_RATE_LIMIT 100
+
 typedef enum {
 	DEBUG_LV = 0x1,
 	INFO_LV = 0x2,
@@ -58,15 +114,145 @@ typedef enum {
 	FATAL_LV = 0x10
 } cc_LogLevel;
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Call site of a log, defined by the log macros.
+ *
+ * @details    In binary mode the call site is written once in the output
+ *             stream with an identifier, then the logs only write the
+ *             identifier and the arguments. The logs of a call site beyond the
+ *             rate limit are counted instead of being logged (see @c
+ *             lg_setRateLimit).
+ */
+typedef struct lg_CallSite {
+	const char* file; /**< File of the log */
+	int line; /**< Line of the log */
+	const char* func; /**< Function of the log */
+	cc_LogLevel level; /**< Level of the log */
+	const char* format; /**< Format of the log message */
+	LG_ATOMIC_UINT id; /**< Identifier in the binary logs, 0 if not assigned */
+	LG_ATOMIC_UINT generation; /**< Binary output stream the call site was written in */
+	LG_ATOMIC_UINT window; /**< Second of the rate limit window */
+	LG_ATOMIC_UINT count; /**< Number of logs in the window */
+	LG_ATOMIC_UINT suppressed; /**< Number of logs suppressed, reported once the window expired */
+	LG_ATOMIC_UINT hash; /**< Hash of the arguments of the last message, to detect the repetitions */
+	LG_ATOMIC_UINT repeated; /**< Number of repetitions of the last message not logged */
+	LG_ATOMIC_UINT listed; /**< Listed with the call sites with logs suppressed or repeated to report */
+	struct lg_CallSite* next; /**< Next call site with logs suppressed to report */
+} lg_CallSite;
+
+/*-------------------------------------------------------------------------*//**
+ * @struct lg_LogSink
+ *
+ * @brief      Destination of the printed logs, replacing the output file and
+ *             the output stream.
+ */
+typedef struct {
+	void (* write)(const char* records, size_t size, void* data); /**< Called with the text of one or more logs,
+	                                                                * each ending with '\\n', not terminated by
+	                                                                * '\\0'. Called by the logging threads (or the
+	                                                                * background thread in asynchronous mode),
+	                                                                * concurrently: must be thread-safe and must not
+	                                                                * log */
+	void* data; /**< Data given to the write function */
+} lg_LogSink;
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Levels processed by the logger, 0 if it is disabled, checked by
+ *             the log macros before calling the logger.
+ *
+ * @details    Read only, updated by lg_setEnabled and the levels functions.
+ */
+#if !defined(__cplusplus) || __cplusplus >= 202302L
+extern atomic_uint lg_processedLevels;
+#endif
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Get the levels processed by the logger, 0 if it is disabled.
+ *
+ * @details    Used by the log macros in C++ before C++23, which cannot read
+ *             @c lg_processedLevels.
+ *
+ * @return     The levels processed
+ */
+unsigned int lg_getProcessedLevels();
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set the logger output stream, if NULL, stderr is used.
  *
- * @details    Default value is NULL, stderr is used.
+ * @details    The configuration functions can be called while other threads
+ *             log, the configuration is read atomically without lock (the
+ *             previous output stream must stay open while the logs started
+ *             before the call are written). In synchronous mode, each thread
+ *             prints its logs in its own buffer and writes each log to the
+ *             output stream with one call: the logs of several threads are
+ *             not interleaved (except on Windows). Default value is NULL,
+ *             stderr is used.
  *
  * @param      outputStream  The logger output stream
  */
 void lg_setOutputStream(FILE* outputStream);
 
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the logger output file, if NULL, the logs are written to
+ *             the output stream.
+ *
+ * @details    The file is written in segments of fixed size, preallocated and
+ *             memory-mapped: a log is copied in the mapping, without system
+ *             call. When the current segment is full, it is renamed path.1
+ *             (path.1 being renamed path.2 and so on) and a new segment is
+ *             started, at most segmentsNumber segments are kept. The existing
+ *             file is rotated the same way when it is set. The current segment
+ *             has the segment size until it is rotated or the output file is
+ *             changed (or the program exits), it is then trimmed to its
+ *             content. Logs larger than a segment are truncated. If a segment
+ *             cannot be created, the logs are written to the output stream.
+ *             Not available on Windows. Default value: NULL
+ *
+ * @param[in]  path            The output file path
+ * @param[in]  segmentSize     The size of a segment, in bytes
+ * @param[in]  segmentsNumber  The maximal number of segments kept, including
+ *                             the current one
+ *
+ * @return     true if the output file was set, false if it could not be
+ *             created
+ */
+bool lg_setOutputFile(const char* path, size_t segmentSize, unsigned int segmentsNumber);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the log sink, if NULL, the logs are written to the output
+ *             file or the output stream.
+ *
+ * @details    The logs are printed with the log printer then given to the
+ *             sink (a log pane of the UI for example, instead of the console
+ *             the UI is drawn on). The sink must stay valid while it is set,
+ *             and until the logs started before it is replaced are written.
+ *             Not available on Windows. Default value: NULL
+ *
+ * @param[in]  logSink  The log sink
+ */
+void lg_setLogSink(const lg_LogSink* logSink);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the maximal number of logs per second of a call site.
+ *
+ * @details    A log macro called in a hot loop (a warning on each redraw for
+ *             example) logs at most this number of times per second, the
+ *             other logs are counted and reported with "N messages
+ *             suppressed", with the location and level of the call site (never
+ *             binary), by the first limited log of a next second (of any call
+ *             site), by the background thread in asynchronous mode, and at
+ *             exit. The consecutive identical messages of a call site (same
+ *             format and arguments) are logged once, their repetitions are
+ *             reported with "Last message repeated N times", before the next
+ *             different message or as the suppressed logs. The
+ *             logs of lg_log are not limited. Default value:
+ *             LOG_DEFAULT_RATE_LIMIT
+ *
+ * @param[in]  logsPerSecond  The number of logs per second of a call site, 0
+ *                            for no limit (and no repetitions detection)
+ */
+void lg_setRateLimit(unsigned int logsPerSecond);
+
 /*-------------------------------------------------------------------------*//**
  * @brief      Set if the logger is enabled or not.
  *
@@ -106,7 +292,10 @@ void lg_removeLevels(unsigned int levels);
  * @details    The functions parameters are (output stream, log instant timeinfo
  *             struct, file of the log, line of the log, function of the log,
  *             level of the log, format of the log message, arguments of the log
- *             message). Default value: &lg_simpleLogPrinter
+ *             message). In synchronous mode the output stream given is the
+ *             buffer of the logging thread, written to the logger output
+ *             stream and flushed after the printer returns. Default value:
+ *             &lg_simpleLogPrinter
  *
  * @param      logPrinter  The log printer function
  */
@@ -114,11 +303,88 @@ void lg_setLogPrinter(void (* logPrinter)
 	(FILE*, struct tm*, const char*, const int, const char*, const char*, const char*, va_list));
 
 /*-------------------------------------------------------------------------*//**
- * @brief      Log a message with the configured log printer.
+ * @brief      Set if the logs are printed asynchronously, by a background
+ *             thread.
+ *
+ * @details    In asynchronous mode, lg_log formats the message in a slot of a
+ *             lock-free ring buffer and returns without I/O, the background
+ *             thread prints the messages in batches with the log printer and
+ *             flushes the output stream after each batch. When the ring buffer
+ *             is full the messages are dropped, their number is printed.
+ *             The messages are truncated to LOG_MESSAGE_SIZE - 1 characters.
+ *             The waiting messages are printed when the asynchronous mode is
+ *             disabled and at exit. The output stream, output file, log sink
+ *             and log printer can be changed in asynchronous mode, the changes
+ *             apply from the next batch: the previous output stream must stay
+ *             open until the batch being printed is written. Not available on
+ *             Windows. Default value: false
+ *
+ * @param[in]  asynchronous  True for asynchronous, false for synchronous
+ *
+ * @return     true if the mode was set, false if the background thread
+ *             could not be started
+ */
+bool lg_setAsynchronous(bool asynchronous);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Set the binary output stream, if NULL, the binary mode is
+ *             disabled.
+ *
+ * @details    In binary mode, the logs of the log macros are not formatted:
+ *             the call site is written once (file, line, function, level and
+ *             format), then each log only writes its identifier, its time and
+ *             the raw values of its arguments (the strings are copied, in the
+ *             limit of the record size). The output stream should be opened
+ *             in binary mode and fully buffered, it is not flushed after each
+ *             log. The binary logs are read with lg_decodeBinaryLog (LogDecoder
+ *             tool), on a machine with the same byte order. lg_log is not
+ *             affected. The previous binary output stream must stay open
+ *             while the logs started before the call are written. Default
+ *             value: NULL
+ *
+ * @param      outputStream  The binary output stream
+ *
+ * @return     true if the binary mode was set, false if the header could not
+ *             be written
+ */
+bool lg_setBinaryOutputStream(FILE* outputStream);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Decode binary logs and print them with the configured log
+ *             printer.
+ *
+ * @param      inputStream   The binary logs stream
+ * @param      outputStream  The output stream of the printed logs
+ *
+ * @return     true if the binary logs were decoded, false if they are invalid
+ *             or truncated
+ */
+bool lg_decodeBinaryLog(FILE* inputStream, FILE* outputStream);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Log a message of a call site, in binary mode if a binary output
+ *             stream is set, with the configured log printer otherwise.
  *
  * @details    Use the LOG_DEBUG, LOG_INFO, LOG_WARN, LOG_ERROR, LOG_FATAL
- *             macros functions to automatically fill the file, line, func and
- *             level parameters
+ *             macros functions to define the call site. A format other than
+ *             the one of the call site (a format computed at run time, in C++)
+ *             is logged as text, even in binary mode.
+ *
+ * @param      callSite  The call site of the log
+ * @param[in]  format    The format of the log message, the format of the call
+ *                       site
+ * @param[in]  ...       The arguments of the log message
+ */
+void lg_logCallSite(lg_CallSite* callSite, const char* format, ...);
+
+/*-------------------------------------------------------------------------*//**
+ * @brief      Log a message with the configured log printer.
+ *
+ * @details    The LOG_DEBUG, LOG_INFO, LOG_WARN, LOG_ERROR, LOG_FATAL macros
+ *             functions use lg_logCallSite instead, the file, line, func and
+ *             level being filled automatically, and need a string literal
+ *             format: lg_log logs the messages which format is computed at
+ *             run time. lg_log is never binary.
  *
  * @param[in]  file       The file of the log (where the log happened not where
  *                        it should be print)
@@ -24,8 +24,28 @@
  *                                                                                       *
  *****************************************************************************************/
 
+// For localtime_r and clock_gettime
+#define _POSIX_C_SOURCE 200809L
+
 #include <log.h>
 
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#define LOG_ASYNCHRONOUS_AVAILABLE
+#define LOG_THREAD_BUFFERS_AVAILABLE
+#define LOG_FILE_AVAILABLE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #ifdef UNUSED
 #elif defined(__GNUC__)
 # define UNUSED(x) x __attribute__((unused))
@@ -35,22 +55,323 @@
 # define UNUSED(x) x
 #endif
 
+typedef void (* log_printer)(FILE*, struct tm*, const char*, int, const char*, const char*, const char*, va_list);
+
+/* Read without lock by the logging threads, the setters are serialized by the lock */
 typedef struct {
-	FILE* outputStream;
-	bool enabled;
-	unsigned int levels;
-	void (* logPrinter)(FILE*, struct tm*, const char*, int, const char*, const char*, const char*, va_list);
+	_Atomic(FILE*) outputStream;
+	atomic_bool enabled;
+	atomic_uint levels;
+	_Atomic(log_printer) logPrinter;
+	_Atomic(const lg_LogSink*) logSink;
+	atomic_uint rateLimit;
+	atomic_flag lock;
 } log_config;
 
 log_config loggerConfig = {
 	NULL, // default: stderr
 	LOGGER_ENABLED,
 	DEBUG_LV | INFO_LV | WARN_LV | ERROR_LV | FATAL_LV,
-	&lg_simpleLogPrinter
+	&lg_simpleLogPrinter,
+	NULL,
+	LOG_DEFAULT_RATE_LIMIT,
+	ATOMIC_FLAG_INIT
 };
 
+atomic_uint lg_processedLevels = LOGGER_ENABLED ? DEBUG_LV | INFO_LV | WARN_LV | ERROR_LV | FATAL_LV : 0;
+
+/* The call sites atomic members are declared unsigned int in C++ before C++23 (see LG_ATOMIC_UINT) */
+_Static_assert(sizeof(atomic_uint) == sizeof(unsigned int) && _Alignof(atomic_uint) == _Alignof(unsigned int),
+               "atomic_uint and unsigned int layouts differ");
+
 const char* getLevelText(cc_LogLevel level);
 
+// For lg_setEnabled and the levels functions, update the levels with the configuration lock taken
+static void updateLevels(bool enabled, unsigned int setLevels, unsigned int clearedLevels);
+
+// For logMessage and printMessages
+static FILE* getOutputStream(void);
+
+#ifdef LOG_THREAD_BUFFERS_AVAILABLE
+
+/* Memory stream a thread prints its messages in, written to the output stream at once: the lines of several
+ * threads are not interleaved */
+typedef struct {
+	FILE* stream; /* NULL if not created */
+	char* data;
+	size_t size;
+} log_buffer;
+
+// For getThreadBuffer
+static _Thread_local log_buffer threadBuffer = {
+	.stream = NULL,
+	.data = NULL,
+	.size = 0
+};
+
+// For getThreadBuffer, destroys the buffer of a thread when it exits
+static pthread_key_t threadBufferKey;
+static pthread_once_t threadBufferKeyOnce = PTHREAD_ONCE_INIT;
+
+// For logMessage and printMessages, NULL if the buffer could not be created
+static log_buffer* getThreadBuffer(void);
+
+// For logMessage and printMessages, write the records of a thread buffer to the log sink, the output file or the
+// output stream
+static void writeRecords(const char* records, size_t size, FILE* outputStream);
+
+// For getThreadBuffer
+static void createThreadBufferKey(void);
+
+// For createThreadBufferKey
+static void destroyThreadBuffer(void* buffer);
+
+#endif //LOG_THREAD_BUFFERS_AVAILABLE
+
+#ifdef LOG_FILE_AVAILABLE
+
+/* Rotating output file: the logs are copied in the mapping of the current segment, preallocated, which is renamed
+ * path.1 (path.1 renamed path.2...) when full */
+typedef struct {
+	char* path; /* NULL if no output file is set */
+	char* segmentPath; /* buffer for the rotated segments paths */
+	size_t segmentSize;
+	unsigned int segmentsNumber;
+	int fd;
+	char* mapping;
+	size_t position;
+	atomic_bool opened; /* checked without lock before writing */
+	pthread_mutex_t mutex; /* held while writing, rotating or changing the file, the holder can wait for the disk */
+	bool exitRegistered;
+} log_file;
+
+// For writeFile and lg_setOutputFile
+static log_file loggerFile = {
+	.path = NULL,
+	.segmentPath = NULL,
+	.segmentSize = 0,
+	.segmentsNumber = 0,
+	.fd = -1,
+	.mapping = NULL,
+	.position = 0,
+	.opened = false,
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.exitRegistered = false
+};
+
+// For writeRecords, false if no output file is set
+static bool writeFile(const char* data, size_t size);
+
+// For writeFile and lg_setOutputFile, rename the segments then open a new one, mutex held
+static bool rotateFile(void);
+
+// For rotateFile and lg_setOutputFile, trim the current segment to its content then unmap it, mutex held
+static void closeSegment(void);
+
+// For lg_setOutputFile
+static void closeFileAtExit(void);
+
+#endif //LOG_FILE_AVAILABLE
+
+/* Last time converted and formatted by a thread, the conversion takes a lock and may read the time zone database
+ * so it is done only when the second changes */
+typedef struct {
+	time_t time;
+	struct tm timeinfo;
+	char text[20];
+} log_time;
+
+// For getTimeinfo and getTimeText
+static _Thread_local log_time cachedTime = {
+	.time = -1
+};
+
+// For lg_log
+static time_t getCurrentTime(void);
+
+/* Call sites with logs suppressed by the rate limit or repeated, listed by the thread counting their first log */
+typedef struct {
+	lg_CallSite* first;
+	atomic_bool pending; /* call sites listed, checked without lock */
+	atomic_uint checked; /* second the expired windows were last reported */
+	atomic_flag lock; /* taken to list the call sites, not while reporting them */
+	bool exitRegistered;
+} log_suppressed;
+
+static log_suppressed suppressedLogs = {
+	.first = NULL,
+	.pending = false,
+	.checked = 0,
+	.lock = ATOMIC_FLAG_INIT,
+	.exitRegistered = false
+};
+
+// For lg_logCallSite, false if the log is beyond the rate limit of the call site or repeats its last message
+static bool checkRateLimit(lg_CallSite* callSite, const char* format, va_list args);
+
+// For checkRateLimit, list the call site with the ones with logs to report if it is not
+static void listCallSite(lg_CallSite* callSite);
+
+// For checkRateLimit and printThread, report the logs suppressed in the windows expired, once per second
+static void checkSuppressed(void);
+
+// For checkSuppressed and reportSuppressedAtExit, report the logs suppressed in the windows expired, or in all the
+// windows
+static void reportSuppressed(bool all);
+
+// For listCallSite, registered with atexit
+static void reportSuppressedAtExit(void);
+
+// For reportSuppressed, log a message given as format and arguments
+static void logText(const char* file, int line, const char* func, cc_LogLevel level, const char* format, ...);
+
+// For printMessages and lg_decodeBinaryLog, print a message with the configured log printer
+static void printMessage(FILE* outputStream, struct tm* timeinfo, const char* file, int line, const char* func,
+                         cc_LogLevel level, const char* format, ...);
+
+// For lg_log and lg_logCallSite
+static void logMessage(const char* file, int line, const char* func, cc_LogLevel level, const char* format,
+                       va_list args);
+
+// Binary logs header, followed by the version
+#define LOG_BINARY_MAGIC "CCBINLOG"
+#define LOG_BINARY_VERSION 1
+
+// Maximal size of a binary log record (the strings arguments are truncated)
+#define LOG_RECORD_SIZE 512
+
+// Size of the header of the binary log records: type (1 byte) and size (2 bytes)
+#define LOG_RECORD_HEADER_SIZE 3
+
+// Call sites identifiers above are rejected when decoding, the call sites are indexed by identifier
+#define LOG_CALL_SITES_MAX (1u << 20)
+
+typedef enum {
+	CALL_SITE_RECORD = 1, /* identifier, level, line, file, function, format */
+	LOG_RECORD = 2 /* identifier, seconds, nanoseconds, arguments */
+} log_recordType;
+
+/* Type of the argument of a printf conversion, the integers are written on 8 bytes, the floating point numbers as
+ * doubles and the strings with their length on 2 bytes */
+typedef enum {
+	NO_ARGUMENT,
+	INT_ARGUMENT,
+	LONG_ARGUMENT,
+	LONG_LONG_ARGUMENT,
+	INTMAX_ARGUMENT,
+	SIZE_ARGUMENT,
+	PTRDIFF_ARGUMENT,
+	DOUBLE_ARGUMENT,
+	LONG_DOUBLE_ARGUMENT,
+	STRING_ARGUMENT,
+	POINTER_ARGUMENT,
+	INVALID_ARGUMENT /* unsupported conversion, the next arguments are ignored */
+} log_argumentType;
+
+typedef struct {
+	_Atomic(FILE*) outputStream; /* NULL if the binary mode is disabled */
+	atomic_uint generation; /* incremented for each output stream, the call sites are written again */
+	atomic_uint lastId;
+	atomic_flag lock; /* taken to write the call sites */
+} log_binary;
+
+static log_binary binaryLog = {
+	.outputStream = NULL,
+	.generation = 0,
+	.lastId = 0,
+	.lock = ATOMIC_FLAG_INIT
+};
+
+// For lg_logCallSite and lg_decodeBinaryLog, parse the conversion after a '%', return the position after it
+static const char* parseConversion(const char* format, log_argumentType* type, unsigned int* stars);
+
+// For lg_logCallSite, write the call site in the binary output stream if it was not
+static bool writeCallSite(lg_CallSite* callSite);
+
+// For writeCallSite
+static void writeString(char* record, size_t* size, const char* string, size_t length);
+
+// For lg_logCallSite and hashArguments, write the arguments of the format, return the record size
+static size_t writeArguments(char* record, size_t size, const char* format, va_list* args);
+
+// For checkRateLimit, hash of the format and its arguments, never 0
+static unsigned int hashArguments(const char* format, va_list args);
+
+// For writeArguments, return false if the record is full
+static bool writeArgument(char* record, size_t* size, log_argumentType type, va_list* args);
+
+// For lg_decodeBinaryLog, format the message of a log record
+static void formatMessage(char* message, size_t messageSize, const char* format, const char* arguments,
+                          size_t argumentsSize);
+
+// For lg_log and printMessages, the time converted to local time
+static struct tm* getTimeinfo(time_t time);
+
+// For lg_simpleLogPrinter and lg_completeLogPrinter, the time formatted in buffer (or the cached text)
+static const char* getTimeText(const struct tm* timeinfo, char* buffer, size_t size);
+
+#ifdef LOG_ASYNCHRONOUS_AVAILABLE
+
+// Number of messages of the ring buffer, power of 2
+#define LOG_RING_SIZE 1024
+
+// Maximal time the background thread waits for messages before checking the ring buffer, in milliseconds
+#define LOG_WAIT_TIMEOUT 100
+
+/* Message slot, sequence == position when it can be written, position + 1 when it can be read */
+typedef struct {
+	atomic_size_t sequence;
+	time_t time;
+	const char* file;
+	int line;
+	const char* func;
+	cc_LogLevel level;
+	char message[LOG_MESSAGE_SIZE];
+} log_slot;
+
+/* Bounded multiple producers single consumer ring buffer (Dmitry Vyukov), the producers claim a position with a
+ * compare and swap then fill the slot, the background thread prints the slots in order */
+typedef struct {
+	log_slot slots[LOG_RING_SIZE];
+	atomic_size_t writePosition;
+	size_t readPosition; /* background thread only */
+	atomic_size_t dropped; /* messages dropped because the ring buffer was full */
+	atomic_bool running;
+	atomic_uint pushing; /* producers which saw the ring running, the ring is drained once they all pushed */
+	atomic_bool sleeping; /* background thread waiting for messages, the first producer signals it */
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	bool initialized; /* slots sequences initialized, stop registered with atexit */
+} log_ring;
+
+static log_ring loggerRing = {
+	.writePosition = 0,
+	.readPosition = 0,
+	.dropped = 0,
+	.running = false,
+	.pushing = 0,
+	.sleeping = false,
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.condition = PTHREAD_COND_INITIALIZER,
+	.initialized = false
+};
+
+// For lg_log, return false if the ring buffer is full
+static bool pushMessage(const char* file, int line, const char* func, cc_LogLevel level, const char* format,
+                        va_list args);
+
+// For printThread, print the messages of the ring buffer, return the number printed
+static size_t printMessages(void);
+
+// For lg_setAsynchronous, the background thread
+static void* printThread(void* data);
+
+// For lg_setAsynchronous, registered with atexit
+static void stopAsynchronous(void);
+
+#endif //LOG_ASYNCHRONOUS_AVAILABLE
+
 const char* getLevelText(cc_LogLevel level) {
 	switch(level) {
 		case DEBUG_LV:
@@ -68,43 +389,1167 @@ const char* getLevelText(cc_LogLevel level) {
 	}
 }
 
+time_t getCurrentTime() {
+#ifdef CLOCK_REALTIME_COARSE
+	/* Updated only on ticks, enough for a precision of one second and cheaper */
+	struct timespec now;
+	if(clock_gettime(CLOCK_REALTIME_COARSE, &now) == 0) {
+		return now.tv_sec;
+	}
+#endif
+	return time(NULL);
+}
+
+struct tm* getTimeinfo(time_t time) {
+	if(time != cachedTime.time) {
+#if defined(_WIN32) || defined(_WIN64)
+		localtime_s(&cachedTime.timeinfo, &time);
+#else
+		localtime_r(&time, &cachedTime.timeinfo);
+#endif
+		strftime(cachedTime.text, sizeof(cachedTime.text), "%Y-%m-%d %H:%M:%S", &cachedTime.timeinfo);
+		cachedTime.time = time;
+	}
+	return &cachedTime.timeinfo;
+}
+
+const char* getTimeText(const struct tm* timeinfo, char* buffer, size_t size) {
+	if(timeinfo == &cachedTime.timeinfo) {
+		return cachedTime.text;
+	}
+	strftime(buffer, size, "%Y-%m-%d %H:%M:%S", timeinfo);
+	return buffer;
+}
+
+void printMessage(FILE* outputStream, struct tm* timeinfo, const char* file, int line, const char* func,
+                  cc_LogLevel level, const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	log_printer logPrinter = atomic_load_explicit(&loggerConfig.logPrinter, memory_order_acquire);
+	logPrinter(outputStream, timeinfo, file, line, func, getLevelText(level), format, args);
+	va_end(args);
+}
+
+FILE* getOutputStream() {
+	FILE* outputStream = atomic_load_explicit(&loggerConfig.outputStream, memory_order_acquire);
+	return outputStream != NULL ? outputStream : stderr;
+}
+
+#ifdef LOG_THREAD_BUFFERS_AVAILABLE
+
+log_buffer* getThreadBuffer() {
+	if(threadBuffer.stream == NULL) {
+		pthread_once(&threadBufferKeyOnce, createThreadBufferKey);
+		threadBuffer.stream = open_memstream(&threadBuffer.data, &threadBuffer.size);
+		if(threadBuffer.stream == NULL) {
+			return NULL;
+		}
+		pthread_setspecific(threadBufferKey, &threadBuffer);
+	}
+	return &threadBuffer;
+}
+
+void createThreadBufferKey() {
+	int error = pthread_key_create(&threadBufferKey, destroyThreadBuffer);
+	if(error) {
+		fprintf(stderr, "Logger: pthread_key_create failed (%s)\n", strerror(error));
+	}
+}
+
+void writeRecords(const char* records, size_t size, FILE* outputStream) {
+	const lg_LogSink* logSink = atomic_load_explicit(&loggerConfig.logSink, memory_order_acquire);
+	if(logSink != NULL) {
+		logSink->write(records, size, logSink->data);
+		return;
+	}
+#ifdef LOG_FILE_AVAILABLE
+	if(writeFile(records, size)) {
+		return;
+	}
+#endif //LOG_FILE_AVAILABLE
+	fwrite(records, size, 1, outputStream);
+	fflush(outputStream);
+}
+
+void destroyThreadBuffer(void* buffer) {
+	log_buffer* logBuffer = buffer;
+	fclose(logBuffer->stream);
+	free(logBuffer->data);
+	logBuffer->stream = NULL;
+	logBuffer->data = NULL;
+	logBuffer->size = 0;
+}
+
+#endif //LOG_THREAD_BUFFERS_AVAILABLE
+
+#ifdef LOG_FILE_AVAILABLE
+
+bool writeFile(const char* data, size_t size) {
+	if(!atomic_load_explicit(&loggerFile.opened, memory_order_relaxed)) {
+		return false;
+	}
+	pthread_mutex_lock(&loggerFile.mutex);
+	if(loggerFile.mapping == NULL) {
+		pthread_mutex_unlock(&loggerFile.mutex);
+		return false;
+	}
+
+	if(loggerFile.position + size > loggerFile.segmentSize && loggerFile.position > 0 && !rotateFile()) {
+		/* Logs written to the output stream from now */
+		atomic_store(&loggerFile.opened, false);
+		pthread_mutex_unlock(&loggerFile.mutex);
+		return false;
+	}
+	if(size > loggerFile.segmentSize) {
+		size = loggerFile.segmentSize;
+	}
+	memcpy(&loggerFile.mapping[loggerFile.position], data, size);
+	loggerFile.position += size;
+
+	pthread_mutex_unlock(&loggerFile.mutex);
+	return true;
+}
+
+bool rotateFile() {
+	closeSegment();
+
+	for(unsigned int i = loggerFile.segmentsNumber - 1; i > 0; --i) {
+		char* newPath = loggerFile.segmentPath;
+		sprintf(newPath, "%s.%u", loggerFile.path, i);
+		if(i > 1) {
+			char* oldPath = newPath + strlen(newPath) + 1;
+			sprintf(oldPath, "%s.%u", loggerFile.path, i - 1);
+			rename(oldPath, newPath);
+		}
+		else {
+			rename(loggerFile.path, newPath);
+		}
+	}
+
+	loggerFile.fd = open(loggerFile.path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if(loggerFile.fd == -1) {
+		fprintf(stderr, "Logger: open failed (%s)\n", strerror(errno));
+		return false;
+	}
+
+	/* Blocks allocated now rather than on the first writes to the mapping */
+	off_t size = (off_t) loggerFile.segmentSize;
+	int error = posix_fallocate(loggerFile.fd, 0, size);
+	if(error && ftruncate(loggerFile.fd, size) == -1) {
+		fprintf(stderr, "Logger: ftruncate failed (%s)\n", strerror(errno));
+		close(loggerFile.fd);
+		loggerFile.fd = -1;
+		return false;
+	}
+
+	void* mapping = mmap(NULL, loggerFile.segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, loggerFile.fd, 0);
+	if(mapping == MAP_FAILED) {
+		fprintf(stderr, "Logger: mmap failed (%s)\n", strerror(errno));
+		close(loggerFile.fd);
+		loggerFile.fd = -1;
+		return false;
+	}
+	loggerFile.mapping = mapping;
+	loggerFile.position = 0;
+	return true;
+}
+
+void closeSegment() {
+	if(loggerFile.mapping != NULL) {
+		munmap(loggerFile.mapping, loggerFile.segmentSize);
+		loggerFile.mapping = NULL;
+	}
+	if(loggerFile.fd != -1) {
+		if(ftruncate(loggerFile.fd, (off_t) loggerFile.position) == -1) {
+			fprintf(stderr, "Logger: ftruncate failed (%s)\n", strerror(errno));
+		}
+		close(loggerFile.fd);
+		loggerFile.fd = -1;
+	}
+	loggerFile.position = 0;
+}
+
+void closeFileAtExit() {
+	/* The waiting messages are printed in the file before it is closed */
+	lg_setAsynchronous(false);
+	lg_setOutputFile(NULL, 0, 0);
+}
+
+#endif //LOG_FILE_AVAILABLE
+
+void updateLevels(bool enabled, unsigned int setLevels, unsigned int clearedLevels) {
+	while(atomic_flag_test_and_set_explicit(&loggerConfig.lock, memory_order_acquire)) {
+		continue;
+	}
+	atomic_store(&loggerConfig.enabled, enabled);
+	unsigned int levels = (atomic_load(&loggerConfig.levels) | setLevels) & ~clearedLevels;
+	atomic_store(&loggerConfig.levels, levels);
+	atomic_store_explicit(&lg_processedLevels, enabled ? levels : 0, memory_order_relaxed);
+	atomic_flag_clear_explicit(&loggerConfig.lock, memory_order_release);
+}
+
+unsigned int lg_getProcessedLevels() {
+	return atomic_load_explicit(&lg_processedLevels, memory_order_relaxed);
+}
+
 void lg_setOutputStream(FILE* outputStream) {
-	loggerConfig.outputStream = outputStream;
+	atomic_store_explicit(&loggerConfig.outputStream, outputStream, memory_order_release);
+}
+
+bool lg_setOutputFile(const char* path, size_t segmentSize, unsigned int segmentsNumber) {
+#ifdef LOG_FILE_AVAILABLE
+	if(path != NULL && (segmentSize == 0 || segmentsNumber == 0)) {
+		return false;
+	}
+
+	pthread_mutex_lock(&loggerFile.mutex);
+	atomic_store(&loggerFile.opened, false);
+	closeSegment();
+	free(loggerFile.path);
+	free(loggerFile.segmentPath);
+	loggerFile.path = NULL;
+	loggerFile.segmentPath = NULL;
+
+	bool opened = true;
+	if(path != NULL) {
+		/* Room for two segments paths with their number */
+		size_t length = strlen(path);
+		loggerFile.path = malloc(length + 1);
+		loggerFile.segmentPath = malloc(2 * (length + 12));
+		if(loggerFile.path == NULL || loggerFile.segmentPath == NULL) {
+			fprintf(stderr, "Logger: malloc failed\n");
+			opened = false;
+		}
+		else {
+			memcpy(loggerFile.path, path, length + 1);
+			loggerFile.segmentSize = segmentSize;
+			loggerFile.segmentsNumber = segmentsNumber;
+
+			/* The logs of the previous runs are kept as the first rotated segments */
+			opened = rotateFile();
+		}
+		if(!opened) {
+			free(loggerFile.path);
+			free(loggerFile.segmentPath);
+			loggerFile.path = NULL;
+			loggerFile.segmentPath = NULL;
+		}
+		else if(!loggerFile.exitRegistered) {
+			atexit(closeFileAtExit);
+			loggerFile.exitRegistered = true;
+		}
+		atomic_store(&loggerFile.opened, opened);
+	}
+
+	pthread_mutex_unlock(&loggerFile.mutex);
+	return opened;
+#else
+	(void) segmentSize;
+	(void) segmentsNumber;
+	return path == NULL;
+#endif //LOG_FILE_AVAILABLE
+}
+
+void lg_setLogSink(const lg_LogSink* logSink) {
+	atomic_store_explicit(&loggerConfig.logSink, logSink, memory_order_release);
+}
+
+void lg_setRateLimit(unsigned int logsPerSecond) {
+	atomic_store_explicit(&loggerConfig.rateLimit, logsPerSecond, memory_order_relaxed);
 }
 
 void lg_setEnabled(bool enabled) {
-	loggerConfig.enabled = enabled;
+	updateLevels(enabled, 0, 0);
 }
 
 void lg_setLevels(unsigned int levels) {
-	loggerConfig.levels = levels;
+	updateLevels(atomic_load(&loggerConfig.enabled), levels, ~levels);
 }
 
 void lg_addLevels(unsigned int levels) {
-	loggerConfig.levels |= levels;
+	updateLevels(atomic_load(&loggerConfig.enabled), levels, 0);
 }
 
 void lg_removeLevels(unsigned int levels) {
-	loggerConfig.levels &= !levels;
+	updateLevels(atomic_load(&loggerConfig.enabled), 0, levels);
 }
 
 void lg_setLogPrinter(void (* logPrinter)
 	(FILE*, struct tm*, const char*, int, const char*, const char*, const char*, va_list)) {
-	loggerConfig.logPrinter = logPrinter;
+	atomic_store_explicit(&loggerConfig.logPrinter, logPrinter, memory_order_release);
 }
 
-void lg_log(const char* file, int line, const char* func, cc_LogLevel level, const char* format, ...) {
-	if(loggerConfig.enabled) {
-		if(level & loggerConfig.levels) {
+#ifdef LOG_ASYNCHRONOUS_AVAILABLE
+
+bool pushMessage(const char* file, int line, const char* func, cc_LogLevel level, const char* format,
+                 va_list args) {
+	log_slot* slot;
+	size_t position = atomic_load_explicit(&loggerRing.writePosition, memory_order_relaxed);
+	while(true) {
+		slot = &loggerRing.slots[position & (LOG_RING_SIZE - 1)];
+		size_t sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+		if(sequence == position) {
+			if(atomic_compare_exchange_weak_explicit(&loggerRing.writePosition, &position, position + 1,
+			                                         memory_order_relaxed, memory_order_relaxed)) {
+				break;
+			}
+		}
+		else if(sequence < position) {
+			return false;
+		}
+		else {
+			position = atomic_load_explicit(&loggerRing.writePosition, memory_order_relaxed);
+		}
+	}
+
+	slot->time = getCurrentTime();
+	slot->file = file;
+	slot->line = line;
+	slot->func = func;
+	slot->level = level;
+	vsnprintf(slot->message, LOG_MESSAGE_SIZE, format, args);
+	atomic_store(&slot->sequence, position + 1);
+
+	/* Signal the background thread if it waits (the slot sequence store is ordered before) */
+	if(atomic_load(&loggerRing.sleeping) && atomic_exchange(&loggerRing.sleeping, false)) {
+		pthread_mutex_lock(&loggerRing.mutex);
+		pthread_cond_signal(&loggerRing.condition);
+		pthread_mutex_unlock(&loggerRing.mutex);
+	}
+	return true;
+}
+
+size_t printMessages() {
+	FILE* outputStream = getOutputStream();
+	/* Batch printed in the thread buffer and given at once to the log sink or copied at once in the output file */
+	bool buffered = atomic_load_explicit(&loggerConfig.logSink, memory_order_relaxed) != NULL;
+#ifdef LOG_FILE_AVAILABLE
+	buffered = buffered || atomic_load_explicit(&loggerFile.opened, memory_order_relaxed);
+#endif //LOG_FILE_AVAILABLE
+	log_buffer* buffer = buffered ? getThreadBuffer() : NULL;
+	if(buffer != NULL) {
+		outputStream = buffer->stream;
+	}
+	size_t printed = 0;
+	size_t dropped = atomic_exchange(&loggerRing.dropped, 0);
+	if(dropped > 0) {
+		fprintf(outputStream, "%zu log messages dropped (ring buffer full)\n", dropped);
+	}
+
+	while(true) {
+		size_t position = loggerRing.readPosition;
+		log_slot* slot = &loggerRing.slots[position & (LOG_RING_SIZE - 1)];
+		if(atomic_load_explicit(&slot->sequence, memory_order_acquire) != position + 1) {
+			break;
+		}
+
+		printMessage(outputStream, getTimeinfo(slot->time), slot->file, slot->line, slot->func, slot->level, "%s", slot->message);
+		atomic_store_explicit(&slot->sequence, position + LOG_RING_SIZE, memory_order_release);
+		loggerRing.readPosition = position + 1;
+		++printed;
+	}
+
+	if(printed > 0 || dropped > 0) {
+		fflush(outputStream);
+		if(buffer != NULL) {
+			writeRecords(buffer->data, buffer->size, getOutputStream());
+		}
+	}
+	if(buffer != NULL) {
+		fseeko(buffer->stream, 0, SEEK_SET);
+	}
+	return printed;
+}
+
+void* printThread(void* UNUSED(data)) {
+	while(atomic_load(&loggerRing.running)) {
+		/* Reported even if the limited call sites do not log anymore */
+		checkSuppressed();
+		if(printMessages() > 0) {
+			continue;
+		}
+
+		/* The producers see the flag set or the thread sees their messages */
+		pthread_mutex_lock(&loggerRing.mutex);
+		atomic_store(&loggerRing.sleeping, true);
+		log_slot* slot = &loggerRing.slots[loggerRing.readPosition & (LOG_RING_SIZE - 1)];
+		if(atomic_load(&slot->sequence) != loggerRing.readPosition + 1 && atomic_load(&loggerRing.running)) {
+			struct timespec timeout;
+			clock_gettime(CLOCK_REALTIME, &timeout);
+			timeout.tv_nsec += LOG_WAIT_TIMEOUT * 1000000L;
+			if(timeout.tv_nsec >= 1000000000L) {
+				timeout.tv_nsec -= 1000000000L;
+				++timeout.tv_sec;
+			}
+			pthread_cond_timedwait(&loggerRing.condition, &loggerRing.mutex, &timeout);
+		}
+		atomic_store(&loggerRing.sleeping, false);
+		pthread_mutex_unlock(&loggerRing.mutex);
+	}
+
+	/* Messages logged before the asynchronous mode was disabled */
+	printMessages();
+	return NULL;
+}
+
+void stopAsynchronous() {
+	lg_setAsynchronous(false);
+}
+
+#endif //LOG_ASYNCHRONOUS_AVAILABLE
+
+bool lg_setAsynchronous(bool asynchronous) {
+#ifdef LOG_ASYNCHRONOUS_AVAILABLE
+	if(asynchronous == atomic_load(&loggerRing.running)) {
+		return true;
+	}
+
+	if(asynchronous) {
+		if(!loggerRing.initialized) {
+			for(size_t i = 0; i < LOG_RING_SIZE; ++i) {
+				atomic_init(&loggerRing.slots[i].sequence, i);
+			}
+			atexit(stopAsynchronous);
+			loggerRing.initialized = true;
+		}
+		atomic_store(&loggerRing.running, true);
+		int error = pthread_create(&loggerRing.thread, NULL, printThread, NULL);
+		if(error) {
+			atomic_store(&loggerRing.running, false);
+			fprintf(stderr, "Logger: pthread_create failed (%s)\n", strerror(error));
+			return false;
+		}
+	}
+	else {
+		atomic_store(&loggerRing.running, false);
+		pthread_mutex_lock(&loggerRing.mutex);
+		pthread_cond_signal(&loggerRing.condition);
+		pthread_mutex_unlock(&loggerRing.mutex);
+		pthread_join(loggerRing.thread, NULL);
+
+		/* Messages pushed by the producers which saw the ring running after the thread printed its last ones */
+		while(atomic_load(&loggerRing.pushing) > 0) {
+			sched_yield();
+		}
+		printMessages();
+	}
+	return true;
+#else
+	return !asynchronous;
+#endif //LOG_ASYNCHRONOUS_AVAILABLE
+}
+
+void logMessage(const char* file, int line, const char* func, cc_LogLevel level, const char* format,
+                va_list args) {
+#ifdef LOG_ASYNCHRONOUS_AVAILABLE
+	if(atomic_load_explicit(&loggerRing.running, memory_order_relaxed)) {
+		/* Counted before checking again, lg_setAsynchronous(false) clears running before waiting for the count */
+		atomic_fetch_add(&loggerRing.pushing, 1);
+		if(atomic_load(&loggerRing.running)) {
+			if(!pushMessage(file, line, func, level, format, args)) {
+				atomic_fetch_add_explicit(&loggerRing.dropped, 1, memory_order_relaxed);
+			}
+			atomic_fetch_sub(&loggerRing.pushing, 1);
+			return;
+		}
+		atomic_fetch_sub(&loggerRing.pushing, 1);
+	}
+#endif //LOG_ASYNCHRONOUS_AVAILABLE
+
+	struct tm* timeinfo = getTimeinfo(getCurrentTime());
+	FILE* outputStream = getOutputStream();
+	log_printer logPrinter = atomic_load_explicit(&loggerConfig.logPrinter, memory_order_acquire);
+
+#ifdef LOG_THREAD_BUFFERS_AVAILABLE
+	/* Printed in the thread buffer then written with one call, the stream is locked only for the copy */
+	log_buffer* buffer = getThreadBuffer();
+	if(buffer != NULL) {
+		logPrinter(buffer->stream, timeinfo, file, line, func, getLevelText(level), format, args);
+		fflush(buffer->stream);
+		writeRecords(buffer->data, buffer->size, outputStream);
+		fseeko(buffer->stream, 0, SEEK_SET);
+		return;
+	}
+#endif //LOG_THREAD_BUFFERS_AVAILABLE
+
+	logPrinter(outputStream, timeinfo, file, line, func, getLevelText(level), format, args);
+	fflush(outputStream);
+}
+
+const char* parseConversion(const char* format, log_argumentType* type, unsigned int* stars) {
+	/* Flags, width and precision, '*' taking an int argument */
+	*stars = 0;
+	while(*format != '\0' && strchr("-+ #0123456789.*", *format) != NULL) {
+		if(*format == '*') {
+			++*stars;
+		}
+		++format;
+	}
+
+	/* Length modifier */
+	log_argumentType integerType = INT_ARGUMENT;
+	bool longDouble = false;
+	bool wide = false;
+	switch(*format) {
+		case 'h':
+			++format;
+			if(*format == 'h') {
+				++format;
+			}
+			break;
+		case 'l':
+			++format;
+			integerType = LONG_ARGUMENT;
+			wide = true;
+			if(*format == 'l') {
+				++format;
+				integerType = LONG_LONG_ARGUMENT;
+			}
+			break;
+		case 'j':
+			++format;
+			integerType = INTMAX_ARGUMENT;
+			break;
+		case 'z':
+			++format;
+			integerType = SIZE_ARGUMENT;
+			break;
+		case 't':
+			++format;
+			integerType = PTRDIFF_ARGUMENT;
+			break;
+		case 'L':
+			++format;
+			longDouble = true;
+			break;
+		default:
+			break;
+	}
+
+	/* Conversion specifier */
+	switch(*format) {
+		case 'd':
+		case 'i':
+		case 'u':
+		case 'o':
+		case 'x':
+		case 'X':
+			*type = integerType;
+			break;
+		case 'c':
+			*type = wide ? INVALID_ARGUMENT : INT_ARGUMENT;
+			break;
+		case 'f':
+		case 'F':
+		case 'e':
+		case 'E':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+			*type = longDouble ? LONG_DOUBLE_ARGUMENT : DOUBLE_ARGUMENT;
+			break;
+		case 's':
+			*type = wide ? INVALID_ARGUMENT : STRING_ARGUMENT;
+			break;
+		case 'p':
+			*type = POINTER_ARGUMENT;
+			break;
+		case '%':
+			*type = NO_ARGUMENT;
+			break;
+		default:
+			*type = INVALID_ARGUMENT;
+			return format;
+	}
+	return format + 1;
+}
+
+bool writeCallSite(lg_CallSite* callSite) {
+	/* Identifier assigned once, an identifier lost to another thread is not reused */
+	unsigned int id = atomic_load_explicit(&callSite->id, memory_order_relaxed);
+	if(id == 0) {
+		unsigned int newId = atomic_fetch_add(&binaryLog.lastId, 1) + 1;
+		id = atomic_compare_exchange_strong(&callSite->id, &id, newId) ? newId : id;
+	}
+
+	/* Record built before taking the lock, which is held only to write it */
+	size_t fileLength = strlen(callSite->file);
+	size_t funcLength = strlen(callSite->func);
+	size_t formatLength = strlen(callSite->format);
+	char* record = malloc(LOG_RECORD_HEADER_SIZE + 12 + 6 + fileLength + funcLength + formatLength);
+	if(record == NULL) {
+		return false;
+	}
+	size_t size = LOG_RECORD_HEADER_SIZE;
+	uint32_t values[3] = {id, (uint32_t) callSite->level, (uint32_t) callSite->line};
+	memcpy(&record[size], values, sizeof(values));
+	size += sizeof(values);
+	writeString(record, &size, callSite->file, fileLength);
+	writeString(record, &size, callSite->func, funcLength);
+	writeString(record, &size, callSite->format, formatLength);
+
+	/* The size of a call site record can exceed 2 bytes, it is given as 0 */
+	record[0] = CALL_SITE_RECORD;
+	uint16_t recordSize = size <= UINT16_MAX ? (uint16_t) size : 0;
+	memcpy(&record[1], &recordSize, sizeof(recordSize));
+
+	while(atomic_flag_test_and_set_explicit(&binaryLog.lock, memory_order_acquire)) {
+		continue;
+	}
+
+	/* Checked again, another thread may have written it */
+	unsigned int generation = atomic_load(&binaryLog.generation);
+	bool written = true;
+	if(atomic_load_explicit(&callSite->generation, memory_order_relaxed) != generation) {
+		written = fwrite(record, size, 1, atomic_load_explicit(&binaryLog.outputStream, memory_order_acquire)) == 1;
+		if(written) {
+			atomic_store_explicit(&callSite->generation, generation, memory_order_release);
+		}
+	}
+
+	atomic_flag_clear_explicit(&binaryLog.lock, memory_order_release);
+	free(record);
+	return written;
+}
+
+void writeString(char* record, size_t* size, const char* string, size_t length) {
+	uint16_t stringLength = length <= UINT16_MAX ? (uint16_t) length : UINT16_MAX;
+	memcpy(&record[*size], &stringLength, sizeof(stringLength));
+	memcpy(&record[*size + sizeof(stringLength)], string, stringLength);
+	*size += sizeof(stringLength) + stringLength;
+}
+
+size_t writeArguments(char* record, size_t size, const char* format, va_list* args) {
+	for(const char* c = format; *c != '\0';) {
+		if(*c++ != '%') {
+			continue;
+		}
+		log_argumentType type;
+		unsigned int stars;
+		c = parseConversion(c, &type, &stars);
+		if(type == INVALID_ARGUMENT) {
+			break;
+		}
+		bool full = false;
+		for(unsigned int i = 0; i < stars && !full; ++i) {
+			full = !writeArgument(record, &size, INT_ARGUMENT, args);
+		}
+		if(full || !writeArgument(record, &size, type, args)) {
+			break;
+		}
+	}
+	return size;
+}
+
+unsigned int hashArguments(const char* format, va_list args) {
+	/* Raw values as in the binary records, the strings contents included */
+	char record[LOG_RECORD_SIZE];
+	va_list arguments;
+	va_copy(arguments, args);
+	size_t size = writeArguments(record, 0, format, &arguments);
+	va_end(arguments);
+
+	/* FNV-1a */
+	uint32_t hash = 2166136261u;
+	for(const char* c = format; *c != '\0'; ++c) {
+		hash = (hash ^ (unsigned char) *c) * 16777619u;
+	}
+	for(size_t i = 0; i < size; ++i) {
+		hash = (hash ^ (unsigned char) record[i]) * 16777619u;
+	}
+	return hash != 0 ? hash : 1;
+}
+
+bool writeArgument(char* record, size_t* size, log_argumentType type, va_list* args) {
+	int64_t integer = 0;
+	double real = 0;
+	const void* value = &integer;
+	size_t valueSize = sizeof(integer);
+	switch(type) {
+		case INT_ARGUMENT:
+			integer = va_arg(*args, int);
+			break;
+		case LONG_ARGUMENT:
+			integer = va_arg(*args, long);
+			break;
+		case LONG_LONG_ARGUMENT:
+			integer = va_arg(*args, long long);
+			break;
+		case INTMAX_ARGUMENT:
+			integer = (int64_t) va_arg(*args, intmax_t);
+			break;
+		case SIZE_ARGUMENT:
+			integer = (int64_t) va_arg(*args, size_t);
+			break;
+		case PTRDIFF_ARGUMENT:
+			integer = (int64_t) va_arg(*args, ptrdiff_t);
+			break;
+		case DOUBLE_ARGUMENT:
+			real = va_arg(*args, double);
+			value = &real;
+			valueSize = sizeof(real);
+			break;
+		case LONG_DOUBLE_ARGUMENT:
+			real = (double) va_arg(*args, long double);
+			value = &real;
+			valueSize = sizeof(real);
+			break;
+		case POINTER_ARGUMENT:
+			integer = (int64_t) (uintptr_t) va_arg(*args, void*);
+			break;
+		case STRING_ARGUMENT: {
+			const char* string = va_arg(*args, const char*);
+			if(string == NULL) {
+				string = "(null)";
+			}
+			if(*size + sizeof(uint16_t) > LOG_RECORD_SIZE) {
+				return false;
+			}
+			size_t length = strlen(string);
+			if(length > LOG_RECORD_SIZE - *size - sizeof(uint16_t)) {
+				length = LOG_RECORD_SIZE - *size - sizeof(uint16_t);
+			}
+			writeString(record, size, string, length);
+			return true;
+		}
+		case NO_ARGUMENT:
+		case INVALID_ARGUMENT:
+		default:
+			return true;
+	}
+
+	if(*size + valueSize > LOG_RECORD_SIZE) {
+		return false;
+	}
+	memcpy(&record[*size], value, valueSize);
+	*size += valueSize;
+	return true;
+}
+
+void formatMessage(char* message, size_t messageSize, const char* format, const char* arguments,
+                   size_t argumentsSize) {
+	size_t length = 0;
+	size_t position = 0;
+	while(*format != '\0' && length + 1 < messageSize) {
+		if(*format != '%') {
+			message[length++] = *format++;
+			continue;
+		}
+
+		const char* start = format;
+		log_argumentType type;
+		unsigned int starsNumber;
+		format = parseConversion(format + 1, &type, &starsNumber);
+		if(type == INVALID_ARGUMENT || starsNumber > 2) {
+			/* The arguments are unknown from here, the rest of the format is printed as is */
+			snprintf(&message[length], messageSize - length, "%s", start);
+			return;
+		}
+		if(type == NO_ARGUMENT) {
+			message[length++] = '%';
+			continue;
+		}
+
+		/* Conversion specification, with its width and precision arguments */
+		char specification[32];
+		size_t specificationLength = (size_t) (format - start);
+		if(specificationLength >= sizeof(specification)) {
+			specificationLength = sizeof(specification) - 1;
+		}
+		memcpy(specification, start, specificationLength);
+		specification[specificationLength] = '\0';
+		int stars[2] = {0, 0};
+		for(unsigned int i = 0; i < starsNumber; ++i) {
+			int64_t star;
+			if(position + sizeof(star) > argumentsSize) {
+				snprintf(&message[length], messageSize - length, "<truncated>");
+				return;
+			}
+			memcpy(&star, &arguments[position], sizeof(star));
+			position += sizeof(star);
+			stars[i] = (int) star;
+		}
+
+		char* output = &message[length];
+		size_t outputSize = messageSize - length;
+		int written = 0;
+#define LOG_FORMAT_ARGUMENT(value) \
+		(starsNumber == 0 ? snprintf(output, outputSize, specification, value) \
+		 : starsNumber == 1 ? snprintf(output, outputSize, specification, stars[0], value) \
+		 : snprintf(output, outputSize, specification, stars[0], stars[1], value))
+
+		if(type == STRING_ARGUMENT) {
+			uint16_t stringLength;
+			if(position + sizeof(stringLength) > argumentsSize) {
+				snprintf(output, outputSize, "<truncated>");
+				return;
+			}
+			memcpy(&stringLength, &arguments[position], sizeof(stringLength));
+			position += sizeof(stringLength);
+			if(position + stringLength > argumentsSize) {
+				snprintf(output, outputSize, "<truncated>");
+				return;
+			}
+			char string[LOG_RECORD_SIZE + 1];
+			memcpy(string, &arguments[position], stringLength);
+			string[stringLength] = '\0';
+			position += stringLength;
+			written = LOG_FORMAT_ARGUMENT(string);
+		}
+		else {
+			int64_t integer;
+			double real;
+			if(position + sizeof(integer) > argumentsSize) {
+				snprintf(output, outputSize, "<truncated>");
+				return;
+			}
+			memcpy(&integer, &arguments[position], sizeof(integer));
+			memcpy(&real, &arguments[position], sizeof(real));
+			position += sizeof(integer);
+			switch(type) {
+				case LONG_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT((long) integer);
+					break;
+				case LONG_LONG_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT((long long) integer);
+					break;
+				case INTMAX_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT((intmax_t) integer);
+					break;
+				case SIZE_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT((size_t) integer);
+					break;
+				case PTRDIFF_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT((ptrdiff_t) integer);
+					break;
+				case DOUBLE_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT(real);
+					break;
+				case LONG_DOUBLE_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT((long double) real);
+					break;
+				case POINTER_ARGUMENT:
+					written = LOG_FORMAT_ARGUMENT((void*) (uintptr_t) integer);
+					break;
+				case INT_ARGUMENT:
+				case NO_ARGUMENT:
+				case STRING_ARGUMENT:
+				case INVALID_ARGUMENT:
+				default:
+					written = LOG_FORMAT_ARGUMENT((int) integer);
+					break;
+			}
+		}
+#undef LOG_FORMAT_ARGUMENT
+
+		if(written < 0) {
+			return;
+		}
+		length += (size_t) written < outputSize ? (size_t) written : outputSize - 1;
+	}
+	message[length] = '\0';
+}
+
+bool lg_setBinaryOutputStream(FILE* outputStream) {
+	atomic_store_explicit(&binaryLog.outputStream, NULL, memory_order_release);
+	if(outputStream == NULL) {
+		return true;
+	}
+
+	uint32_t version = LOG_BINARY_VERSION;
+	if(fwrite(LOG_BINARY_MAGIC, sizeof(LOG_BINARY_MAGIC) - 1, 1, outputStream) != 1
+	   || fwrite(&version, sizeof(version), 1, outputStream) != 1) {
+		return false;
+	}
+	atomic_fetch_add(&binaryLog.generation, 1);
+	atomic_store_explicit(&binaryLog.outputStream, outputStream, memory_order_release);
+	return true;
+}
+
+bool lg_decodeBinaryLog(FILE* inputStream, FILE* outputStream) {
+	char magic[sizeof(LOG_BINARY_MAGIC) - 1];
+	uint32_t version;
+	if(fread(magic, sizeof(magic), 1, inputStream) != 1 || memcmp(magic, LOG_BINARY_MAGIC, sizeof(magic)) != 0
+	   || fread(&version, sizeof(version), 1, inputStream) != 1 || version != LOG_BINARY_VERSION) {
+		return false;
+	}
+
+	/* Call sites, indexed by identifier, their strings allocated with them */
+	lg_CallSite** callSites = NULL;
+	size_t callSitesNumber = 0;
+	char* strings = malloc(3 * (UINT16_MAX + 1));
+	bool valid = strings != NULL;
+	char header[LOG_RECORD_HEADER_SIZE];
+	while(valid && fread(header, sizeof(header), 1, inputStream) == 1) {
+		if(header[0] == CALL_SITE_RECORD) {
+			/* Identifier, level, line, then file, function and format */
+			uint32_t values[3];
+			if(fread(values, sizeof(values), 1, inputStream) != 1) {
+				valid = false;
+				break;
+			}
+			size_t stringsSize = 0;
+			for(int i = 0; i < 3 && valid; ++i) {
+				uint16_t length = 0;
+				valid = fread(&length, sizeof(length), 1, inputStream) == 1
+				        && (length == 0 || fread(&strings[stringsSize], length, 1, inputStream) == 1);
+				stringsSize += length;
+				strings[stringsSize++] = '\0';
+			}
+			lg_CallSite* callSite = valid && values[0] <= LOG_CALL_SITES_MAX
+			                        ? malloc(sizeof(lg_CallSite) + stringsSize) : NULL;
+			if(callSite == NULL) {
+				valid = false;
+				break;
+			}
+			char* file = memcpy(callSite + 1, strings, stringsSize);
+			callSite->file = file;
+			callSite->func = file + strlen(file) + 1;
+			callSite->format = callSite->func + strlen(callSite->func) + 1;
+			callSite->level = (cc_LogLevel) values[1];
+			callSite->line = (int) values[2];
+
+			if(values[0] >= callSitesNumber) {
+				lg_CallSite** newCallSites = realloc(callSites, ((size_t) values[0] + 1) * sizeof(lg_CallSite*));
+				if(newCallSites == NULL) {
+					free(callSite);
+					valid = false;
+					break;
+				}
+				callSites = newCallSites;
+				while(callSitesNumber <= values[0]) {
+					callSites[callSitesNumber++] = NULL;
+				}
+			}
+			free(callSites[values[0]]);
+			callSites[values[0]] = callSite;
+		}
+		else if(header[0] == LOG_RECORD) {
+			uint16_t recordSize;
+			memcpy(&recordSize, &header[1], sizeof(recordSize));
+			char record[LOG_RECORD_SIZE];
+			if(recordSize < LOG_RECORD_HEADER_SIZE + 16 || recordSize > LOG_RECORD_SIZE
+			   || fread(record, recordSize - LOG_RECORD_HEADER_SIZE, 1, inputStream) != 1) {
+				valid = false;
+				break;
+			}
+			uint32_t id;
+			int64_t seconds;
+			memcpy(&id, record, sizeof(id));
+			memcpy(&seconds, &record[4], sizeof(seconds));
+			if(id >= callSitesNumber || callSites[id] == NULL) {
+				valid = false;
+				break;
+			}
+
+			lg_CallSite* callSite = callSites[id];
+			char message[4 * LOG_MESSAGE_SIZE];
+			formatMessage(message, sizeof(message), callSite->format, &record[16],
+			              (size_t) recordSize - LOG_RECORD_HEADER_SIZE - 16);
+			printMessage(outputStream, getTimeinfo((time_t) seconds), callSite->file, callSite->line, callSite->func,
+			             callSite->level, "%s", message);
+		}
+		else {
+			valid = false;
+			break;
+		}
+	}
+
+	for(size_t i = 0; i < callSitesNumber; ++i) {
+		free(callSites[i]);
+	}
+	free(callSites);
+	free(strings);
+	fflush(outputStream);
+	return valid && !ferror(inputStream);
+}
+
+bool checkRateLimit(lg_CallSite* callSite, const char* format, va_list args) {
+	unsigned int rateLimit = atomic_load_explicit(&loggerConfig.rateLimit, memory_order_relaxed);
+	if(rateLimit == 0) {
+		return true;
+	}
+
+	/* Reported before the log, which can be the first of the call site in a new window */
+	checkSuppressed();
+
+	/* The thread changing the window resets the count */
+	unsigned int now = (unsigned int) getCurrentTime();
+	unsigned int window = atomic_load_explicit(&callSite->window, memory_order_relaxed);
+	if(window != now && atomic_compare_exchange_strong(&callSite->window, &window, now)) {
+		atomic_store_explicit(&callSite->count, 0, memory_order_relaxed);
+	}
+
+	/* Consecutive identical messages, the repetitions are reported before the next different one */
+	unsigned int hash = hashArguments(format, args);
+	if(atomic_exchange(&callSite->hash, hash) == hash) {
+		atomic_fetch_add(&callSite->repeated, 1);
+		listCallSite(callSite);
+		return false;
+	}
+	unsigned int repeated = atomic_exchange(&callSite->repeated, 0);
+	if(repeated > 0) {
+		logText(callSite->file, callSite->line, callSite->func, callSite->level, "Last message repeated %u times",
+		        repeated);
+	}
+
+	if(atomic_fetch_add_explicit(&callSite->count, 1, memory_order_relaxed) >= rateLimit) {
+		atomic_fetch_add(&callSite->suppressed, 1);
+		listCallSite(callSite);
+		return false;
+	}
+	return true;
+}
+
+void listCallSite(lg_CallSite* callSite) {
+	/* Listed until its logs are reported */
+	if(atomic_exchange(&callSite->listed, 1) != 0) {
+		return;
+	}
+	while(atomic_flag_test_and_set_explicit(&suppressedLogs.lock, memory_order_acquire)) {
+		continue;
+	}
+	callSite->next = suppressedLogs.first;
+	suppressedLogs.first = callSite;
+	atomic_store(&suppressedLogs.pending, true);
+	if(!suppressedLogs.exitRegistered) {
+		atexit(reportSuppressedAtExit);
+		suppressedLogs.exitRegistered = true;
+	}
+	atomic_flag_clear_explicit(&suppressedLogs.lock, memory_order_release);
+}
+
+void checkSuppressed() {
+	if(!atomic_load_explicit(&suppressedLogs.pending, memory_order_relaxed)) {
+		return;
+	}
+	unsigned int now = (unsigned int) getCurrentTime();
+	unsigned int checked = atomic_load_explicit(&suppressedLogs.checked, memory_order_relaxed);
+	if(checked != now && atomic_compare_exchange_strong(&suppressedLogs.checked, &checked, now)) {
+		reportSuppressed(false);
+	}
+}
+
+void reportSuppressed(bool all) {
+	/* The list is taken, the call sites in windows not expired are listed back */
+	while(atomic_flag_test_and_set_explicit(&suppressedLogs.lock, memory_order_acquire)) {
+		continue;
+	}
+	lg_CallSite* callSite = suppressedLogs.first;
+	suppressedLogs.first = NULL;
+	atomic_store(&suppressedLogs.pending, false);
+	atomic_flag_clear_explicit(&suppressedLogs.lock, memory_order_release);
+
+	unsigned int now = (unsigned int) getCurrentTime();
+	lg_CallSite* kept = NULL;
+	lg_CallSite* lastKept = NULL;
+	while(callSite != NULL) {
+		/* Read before the call site is unlisted, a thread can then list it again */
+		lg_CallSite* next = callSite->next;
+		if(all || atomic_load_explicit(&callSite->window, memory_order_relaxed) != now) {
+			atomic_store(&callSite->listed, 0);
+			unsigned int repeated = atomic_exchange(&callSite->repeated, 0);
+			if(repeated > 0) {
+				logText(callSite->file, callSite->line, callSite->func, callSite->level,
+				        "Last message repeated %u times", repeated);
+			}
+			unsigned int suppressed = atomic_exchange(&callSite->suppressed, 0);
+			if(suppressed > 0) {
+				logText(callSite->file, callSite->line, callSite->func, callSite->level, "%u messages suppressed",
+				        suppressed);
+			}
+		}
+		else {
+			callSite->next = kept;
+			kept = callSite;
+			if(lastKept == NULL) {
+				lastKept = callSite;
+			}
+		}
+		callSite = next;
+	}
+
+	if(kept != NULL) {
+		while(atomic_flag_test_and_set_explicit(&suppressedLogs.lock, memory_order_acquire)) {
+			continue;
+		}
+		lastKept->next = suppressedLogs.first;
+		suppressedLogs.first = kept;
+		atomic_store(&suppressedLogs.pending, true);
+		atomic_flag_clear_explicit(&suppressedLogs.lock, memory_order_release);
+	}
+}
+
+void reportSuppressedAtExit() {
+	reportSuppressed(true);
+}
+
+void logText(const char* file, int line, const char* func, cc_LogLevel level, const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	logMessage(file, line, func, level, format, args);
+	va_end(args);
+}
+
+void lg_logCallSite(lg_CallSite* callSite, const char* format, ...) {
+	if(atomic_load_explicit(&loggerConfig.enabled, memory_order_relaxed)) {
+		if(callSite->level & atomic_load_explicit(&loggerConfig.levels, memory_order_relaxed)) {
 			va_list args;
 			va_start(args, format);
+			if(!checkRateLimit(callSite, format, args)) {
+				va_end(args);
+				return;
+			}
+
+			/* The binary records are decoded with the format of the call site (literals not always merged) */
+			FILE* binaryStream = atomic_load_explicit(&binaryLog.outputStream, memory_order_acquire);
+			if(binaryStream == NULL || (format != callSite->format && strcmp(format, callSite->format) != 0)) {
+				logMessage(callSite->file, callSite->line, callSite->func, callSite->level, format, args);
+				va_end(args);
+				return;
+			}
 
-			time_t rawtime;
-			time(&rawtime);
-			struct tm* timeinfo = localtime(&rawtime);
+			if(atomic_load_explicit(&callSite->generation, memory_order_acquire)
+			   != atomic_load_explicit(&binaryLog.generation, memory_order_relaxed)) {
+				if(!writeCallSite(callSite)) {
+					va_end(args);
+					return;
+				}
+			}
 
-			loggerConfig.logPrinter(loggerConfig.outputStream != NULL ? loggerConfig.outputStream : stderr,
-			                        timeinfo, file, line, func, getLevelText(level), format, args);
+			/* Identifier and time, then the raw arguments values */
+			char record[LOG_RECORD_SIZE];
+			struct timespec now;
+			if(timespec_get(&now, TIME_UTC) != TIME_UTC) {
+				now.tv_sec = time(NULL);
+				now.tv_nsec = 0;
+			}
+			uint32_t id = atomic_load_explicit(&callSite->id, memory_order_relaxed);
+			int64_t seconds = now.tv_sec;
+			int32_t nanoseconds = (int32_t) now.tv_nsec;
+			size_t size = LOG_RECORD_HEADER_SIZE;
+			memcpy(&record[size], &id, sizeof(id));
+			memcpy(&record[size + 4], &seconds, sizeof(seconds));
+			memcpy(&record[size + 12], &nanoseconds, sizeof(nanoseconds));
+			size += 16;
+			size = writeArguments(record, size, format, &args);
+			va_end(args);
+
+			record[0] = LOG_RECORD;
+			uint16_t recordSize = (uint16_t) size;
+			memcpy(&record[1], &recordSize, sizeof(recordSize));
+			fwrite(record, size, 1, binaryStream);
+		}
+	}
+}
+
+void lg_log(const char* file, int line, const char* func, cc_LogLevel level, const char* format, ...) {
+	if(atomic_load_explicit(&loggerConfig.enabled, memory_order_relaxed)) {
+		if(level & atomic_load_explicit(&loggerConfig.levels, memory_order_relaxed)) {
+			va_list args;
+			va_start(args, format);
+			logMessage(file, line, func, level, format, args);
 			va_end(args);
 		}
 	}
@@ -113,21 +1558,16 @@ void lg_log(const char* file, int line, const char* func, cc_LogLevel level, con
 void lg_simpleLogPrinter(FILE* outputStream, struct tm* timeinfo, const char* UNUSED(file), int UNUSED(line),
                          const char* func, const char* level, const char* format, va_list args) {
 	char buffer[20];
-	strftime(buffer, 20, "%Y-%m-%d %H:%M:%S", timeinfo);
-
-	fprintf(outputStream, "%s - [%-5s] %s - ", buffer, level, func);
+	fprintf(outputStream, "%s - [%-5s] %s - ", getTimeText(timeinfo, buffer, sizeof(buffer)), level, func);
 	vfprintf(outputStream, format, args);
 	fprintf(outputStream, "\n");
-	fflush(outputStream);
 }
 
 void lg_completeLogPrinter(FILE* outputStream, struct tm* timeinfo, const char* file, int line,
                            const char* func, const char* level, const char* format, va_list args) {
 	char buffer[20];
-	strftime(buffer, 20, "%Y-%m-%d %H:%M:%S", timeinfo);
-
-	fprintf(outputStream, "%s - [%-5s] %s (%s:%d) - ", buffer, level, func, file, line);
+	fprintf(outputStream, "%s - [%-5s] %s (%s:%d) - ", getTimeText(timeinfo, buffer, sizeof(buffer)), level, func,
+	        file, line);
 	vfprintf(outputStream, format, args);
 	fprintf(outputStream, "\n");
-	fflush(outputStream);
 }
@@ -0,0 +1,71 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * MIT License                                                                           *
+ *                                                                                       *
+ * Copyright (c) 2017 Maxime Pinard                                                      *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy          *
+ * of this software and associated documentation files (the "Software"), to deal         *
+ * in the Software without restriction, including without limitation the rights          *
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell             *
+ * copies of the Software, and to permit persons to whom the Software is                 *
+ * furnished to do so, subject to the following conditions:                              *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all        *
+ * copies or substantial portions of the Software.                                       *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR            *
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,              *
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE           *
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER                *
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,         *
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE         *
+ * SOFTWARE.                                                                             *
+ *                                                                                       *
+ *****************************************************************************************/
+
+/* Print binary logs (see lg_setBinaryOutputStream) as text
+ * Usage: LogDecoder [-c] binary_log_file [output_file]
+ *   -c  complete log printer (file and line of the logs) */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <log.h>
+
+int main(int argc, char* argv[]) {
+	int argument = 1;
+	if(argument < argc && strcmp(argv[argument], "-c") == 0) {
+		lg_setLogPrinter(&lg_completeLogPrinter);
+		++argument;
+	}
+	if(argument >= argc || argc - argument > 2) {
+		fprintf(stderr, "Usage: %s [-c] binary_log_file [output_file]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	FILE* input = fopen(argv[argument], "rb");
+	if(input == NULL) {
+		perror(argv[argument]);
+		return EXIT_FAILURE;
+	}
+	FILE* output = stdout;
+	if(argument + 1 < argc) {
+		output = fopen(argv[argument + 1], "w");
+		if(output == NULL) {
+			perror(argv[argument + 1]);
+			fclose(input);
+			return EXIT_FAILURE;
+		}
+	}
+
+	bool decoded = lg_decodeBinaryLog(input, output);
+	if(!decoded) {
+		fprintf(stderr, "%s: invalid or truncated binary logs\n", argv[argument]);
+	}
+	fclose(input);
+	if(output != stdout) {
+		fclose(output);
+	}
+	return decoded ? EXIT_SUCCESS : EXIT_FAILURE;
+}